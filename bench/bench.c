@@ -0,0 +1,403 @@
+/*
+ * Microbenchmarks of the drawing, text, collision, entity, computer opponent
+ * and keypad code, run natively against a stub display bus that only counts the
+ * transfers it is given.
+ *
+ * Build and run with `make bench`. Every benchmark prints one line of
+ * key=value pairs:
+ *
+ *   bench=<name> calls=<n> ns_per_op=<ns> ops_per_sec=<n> bus_ops=<n>
+ *
+ * `ns_per_op` is the best of several runs of `calls` calls. `bus_ops` is the
+ * number of transfers over the bus of the graphic display that one call
+ * causes once the framebuffer is flushed. Each takes about a microsecond on
+ * the board, so that is the cost that matters most there.
+ */
+
+// =============================================================================
+//                         INCLUDES & PRE-PROCESSOR
+
+#include <stdio.h>
+#include <time.h>
+
+#include "typedef.h"
+#include "display_driver.h"
+#include "ks0108.h"
+#include "framebuffer.h"
+#include "font.h"
+#include "graphics.h"
+#include "physics.h"
+#include "entity.h"
+#include "cpu_paddle.h"
+#include "keyb.h"
+#include "ticker.h"
+#include "timer.h"
+#include "render_queue.h"
+
+
+// Each run is made long enough to take at least this long.
+#define MIN_RUN_NS 10000000ull
+
+// The number of runs the best time is picked from.
+#define RUNS 5
+
+typedef unsigned long long u64;
+
+
+// =============================================================================
+//                                  STUBS
+
+static u64 bus_ops = 0;
+
+void ks0108_init(void)                  {}
+void ks0108_command(u8 chips, u8 cmd)   { (void)chips; (void)cmd;  bus_ops++; }
+void ks0108_write(u8 chips, u8 data)    { (void)chips; (void)data; bus_ops++; }
+u8   ks0108_read(u8 chip)               { (void)chip; bus_ops++; return 0; }
+
+
+// Keys 1 and 9 are held, so keyb() has two keys to decode.
+static u32 active_row = 0;
+
+void activate_row(u32 row) { active_row = row; }
+
+u8 read_columns(void)
+{
+    return active_row == 1 ? 0b0001
+         : active_row == 3 ? 0b0100
+         : 0;
+}
+
+
+int ticker_attach(void (*handler)(void)) { (void)handler; return 0; }
+
+
+// The render queue's interrupt runs whenever it is raised, and whenever the
+// queue waits, so a flush has been sent by the time it returns.
+static void (*soft_handler)(void) = NULL;
+
+void soft_irq_attach(void (*handler)(void)) { soft_handler = handler; }
+void soft_irq_raise(void)                   { soft_handler(); }
+void wait_for_interrupt(void)               { soft_handler(); }
+u32 ticker_millis(void)                  { return 0; }
+
+
+// =============================================================================
+//                                GLOBAL DATA
+
+static const u32 ball_pixels[]   = { 0b0110, 0b1111, 0b1111, 0b0110 };
+static const u32 paddle_pixels[] =
+{
+    0b11111, 0b10001, 0b10001, 0b10101, 0b10101,
+    0b10101, 0b10001, 0b10001, 0b11111
+};
+
+static Sprite ball_sprite   = SPRITE(ball_pixels);
+static Sprite paddle_sprite = SPRITE(paddle_pixels);
+
+static Object ball         = { &ball_sprite,   0, 0, INT_TO_FX(62),  INT_TO_FX(30), draw_object, clear_object, NULL, NULL, 0, 0, 0, 0 };
+static Object left_paddle  = { &paddle_sprite, 0, 0, INT_TO_FX(10),  INT_TO_FX(30), draw_object, clear_object, NULL, NULL, 0, 0, 0, 0 };
+static Object right_paddle = { &paddle_sprite, 0, 0, INT_TO_FX(110), INT_TO_FX(30), draw_object, clear_object, NULL, NULL, 0, 0, 0, 0 };
+
+static Line line_h    = { {  1, 32 }, { 128, 32 } };
+static Line line_v    = { { 64,  1 }, {  64, 64 } };
+static Line line_diag = { {  1,  1 }, { 100, 60 } };
+static Rect rect      = { { 10, 10 }, {  40, 30 } };
+
+static const Point poly_points[] =
+{
+    { 20, 10 },
+    { 60, 50 },
+    {  5, 40 },
+};
+
+static Polygon poly = { poly_points, 3, true };
+
+// Results are written here, so the calls can't be optimized away.
+static volatile u32 sink;
+
+
+// =============================================================================
+//                                BENCHMARKS
+
+static void op_line_h(void)    { draw_line(&line_h); }
+static void op_line_v(void)    { draw_line(&line_v); }
+static void op_line_diag(void) { draw_line(&line_diag); }
+static void op_rect(void)      { draw_rect(&rect); }
+static void op_poly(void)      { draw_poly(&poly); }
+static void op_fill_poly(void) { fill_poly(&poly); }
+static void op_draw(void)      { draw_object(&ball); }
+static void op_clear(void)     { clear_object(&ball); }
+
+
+// A paddle drawn a pixel higher and back down again on alternate calls, as
+// render() draws it between ticks. Only its previous position is changed, so
+// the other benchmarks find it where it was.
+static void op_paddle_between(void)
+{
+    static bool up = false;
+
+    up = !up;
+    draw_object_between(&left_paddle, up ? 0 : FX_ONE);
+}
+
+// The same paddle drawn where it already is, as most frames draw it.
+static void op_paddle_still(void)
+{
+    draw_object_between(&left_paddle, FX_ONE);
+}
+
+static void setup_paddle_between(void)
+{
+    left_paddle.prev_y = left_paddle.pos_y - FX_ONE;
+    draw_object(&left_paddle);
+}
+
+
+// The whole screen, in 32 pixel wide strips. Every call turns it all on or
+// all off, so a flush sends every column of every page.
+static const u32 strip[FB_HEIGHT] =
+{
+    [0 ... FB_HEIGHT - 1] = ~0u
+};
+
+static void op_flush_full(void)
+{
+    static bool on = false;
+
+    on = !on;
+    for (int x = 1; x <= FB_WIDTH; x += 32)
+    {
+        if (on) fb_blit (strip, FB_HEIGHT, x, 1);
+        else    fb_erase(strip, FB_HEIGHT, x, 1);
+    }
+    fb_flush();
+    render_queue_drain();
+}
+
+// The same change a pixel at a time, as sending the framebuffer used to.
+static void op_pixels_full(void)
+{
+    static bool on = false;
+
+    on = !on;
+    for (int y = 1; y <= FB_HEIGHT; y++)
+        for (int x = 1; x <= FB_WIDTH; x++)
+        {
+            if (on) graphic_pixel_set  (x, y);
+            else    graphic_pixel_clear(x, y);
+        }
+}
+
+// The scores as they are drawn every frame. Redrawing them unchanged sends
+// nothing; a point scored sends the columns of the digit that changed.
+static void op_scores_same(void)
+{
+    font_draw(&font_digits, "1", 55, 3);
+    font_draw(&font_digits, "2", 69, 3);
+}
+
+static void op_scores_changed(void)
+{
+    static u32 points = 0;
+
+    points = (points + 1) % 10;
+    font_draw(&font_digits, "1", 55, 3);
+    font_draw(&font_digits, (char[]){ '0' + points, '\0' }, 69, 3);
+}
+
+static void op_text_line(void)
+{
+    font_draw(&font_small, "4:CPU 5:2P 6:MULTI", 29, 36);
+}
+
+// A ball in the open, and one that hits the front of the right paddle within
+// the tick. Each call starts from the same state.
+static const Body ball_open   = { INT_TO_FX(62), INT_TO_FX(30), INT_TO_FX(3), INT_TO_FX(1) };
+static const Body ball_paddle = { INT_TO_FX(104), INT_TO_FX(32), INT_TO_FX(3), INT_TO_FX(1) };
+
+static void op_step_open(void)
+{
+    Body body = ball_open;
+    sink = ball_step(&body, &ball_sprite, &left_paddle, &right_paddle, INT_TO_FX(3)).paddle_hits;
+}
+
+static void op_step_paddle(void)
+{
+    Body body = ball_paddle;
+    sink = ball_step(&body, &ball_sprite, &left_paddle, &right_paddle, INT_TO_FX(3)).paddle_hits;
+}
+
+static void op_keyb(void)
+{
+    sink = keyb()->n_presses;
+}
+
+
+// Balls bouncing between the top and bottom walls, between the paddles, so
+// they stay in the field however long the benchmark runs.
+static BallStep outcomes[ENTITY_MAX];
+
+static void spawn_balls(int n)
+{
+    entity_clear();
+    for (int i = 0; i < n; i++)
+        entity_spawn(0, INT_TO_FX(20 + i % 80), INT_TO_FX(1 + i % 56), 0, INT_TO_FX(5));
+}
+
+static void setup_16(void)  { spawn_balls(16); }
+static void setup_256(void) { spawn_balls(ENTITY_MAX); }
+
+static void op_entities_step(void)
+{
+    entities_step(&left_paddle, &right_paddle, INT_TO_FX(5), outcomes);
+}
+
+static void op_entities_draw(void)
+{
+    entity_erase_all();
+    entity_draw_all(FX_ONE);
+}
+
+
+// One ball heading for the right paddle. Updating with an unchanged ball only
+// checks the cache, predicting is the cost of a cache miss.
+static CpuPaddle cpu;
+
+static void setup_cpu(void)
+{
+    entity_clear();
+    entity_spawn(0, INT_TO_FX(40), INT_TO_FX(20), INT_TO_FX(5), INT_TO_FX(3));
+    cpu_paddle_init(&cpu, &right_paddle, 0, 0, 1);
+}
+
+static void op_cpu_update(void)
+{
+    sink = cpu_paddle_update(&cpu);
+}
+
+static void op_cpu_predict(void)
+{
+    sink = cpu_paddle_predict(&right_paddle);
+}
+
+
+/**
+ * @brief One benchmark. `setup` puts the framebuffer and the entity store in
+ *        the state `op` expects, before its pixels are counted.
+ */
+typedef struct
+{
+    const char *name;
+    void      (*op)(void);
+    void      (*setup)(void);
+} Bench;
+
+static const Bench BENCHES[] =
+{
+    { "draw_line_h",            op_line_h,    NULL    },
+    { "draw_line_v",            op_line_v,    NULL    },
+    { "draw_line_diag",         op_line_diag, NULL    },
+    { "draw_rect",              op_rect,      NULL    },
+    { "draw_poly",              op_poly,      NULL    },
+    { "fill_poly",              op_fill_poly, NULL    },
+    { "draw_object",            op_draw,      NULL    },
+    { "clear_object",           op_clear,     op_draw },
+    { "draw_object_between",    op_paddle_between, setup_paddle_between },
+    { "draw_object_still",      op_paddle_still,   setup_paddle_between },
+    { "ball_step_open",         op_step_open,   NULL  },
+    { "ball_step_paddle",       op_step_paddle, NULL  },
+    { "keyb",                   op_keyb,      NULL    },
+    { "entities_step_16",       op_entities_step, setup_16  },
+    { "entities_step_256",      op_entities_step, setup_256 },
+    { "entities_draw_16",       op_entities_draw, setup_16  },
+    { "entities_draw_256",      op_entities_draw, setup_256 },
+    { "cpu_paddle_update",      op_cpu_update,    setup_cpu },
+    { "cpu_paddle_predict",     op_cpu_predict,   setup_cpu },
+    { "flush_full_screen",      op_flush_full,    NULL      },
+    { "pixels_full_screen",     op_pixels_full,   NULL      },
+    { "font_scores_same",       op_scores_same,    op_scores_same },
+    { "font_scores_changed",    op_scores_changed, op_scores_same },
+    { "font_text_line",         op_text_line,      NULL           },
+};
+
+
+// =============================================================================
+//                                 FUNCTIONS
+
+static u64 wall_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+
+static u64 time_calls(void (*op)(void), u64 calls)
+{
+    u64 start = wall_ns();
+
+    for (u64 i = 0; i < calls; i++)
+        op();
+
+    return wall_ns() - start;
+}
+
+
+/**
+ * @brief Count the bus transfers to the display caused by a single call.
+ */
+static u64 count_bus_ops(const Bench *b)
+{
+    fb_clear();
+    if (b->setup)
+        b->setup();
+    fb_flush();
+    render_queue_drain();
+
+    bus_ops = 0;
+    b->op();
+    fb_flush();
+    render_queue_drain();
+
+    return bus_ops;
+}
+
+
+static void run(const Bench *b)
+{
+    u64 transfers = count_bus_ops(b);
+
+    // Double the number of calls until a run is long enough to time.
+    u64 calls = 1;
+    while (time_calls(b->op, calls) < MIN_RUN_NS)
+        calls *= 2;
+
+    u64 best = ~0ull;
+    for (int r = 0; r < RUNS; r++)
+    {
+        u64 ns = time_calls(b->op, calls);
+        if (ns < best)
+            best = ns;
+    }
+
+    double ns_per_op = (double)best / calls;
+
+    printf("bench=%s calls=%llu ns_per_op=%.2f ops_per_sec=%.0f bus_ops=%llu\n",
+        b->name, calls, ns_per_op, 1e9 / ns_per_op, transfers);
+}
+
+
+int main(void)
+{
+    graphic_initialize();
+    render_queue_init();
+    sprite_init(&ball_sprite);
+    sprite_init(&paddle_sprite);
+    entity_add_sprite(&ball_sprite);
+
+    for (u32 i = 0; i < sizeof BENCHES / sizeof BENCHES[0]; i++)
+        run(&BENCHES[i]);
+
+    return 0;
+}
@@ -0,0 +1,662 @@
+/*
+ * Randomized checks of the optimized drawing code against the straightforward
+ * versions it replaced, run natively. Each check draws the same random input
+ * with both and compares the resulting framebuffers. fill_poly() replaced
+ * nothing, so it is checked against a point-in-polygon test instead.
+ *
+ * The computer opponent's analytic prediction of where a ball reaches a
+ * paddle is checked against moving the ball there with ball_step(), and a
+ * paddle drawn between ticks with balls over it against drawing it afresh.
+ *
+ * Build and run with `make check`. Every check prints one line of key=value
+ * pairs, followed by the first input that differed, if any:
+ *
+ *   check=<name> cases=<n> mismatches=<n>
+ *
+ * The inputs only depend on PONG_SEED (default 1). The exit status is 1 if
+ * any check found a mismatch.
+ */
+
+// =============================================================================
+//                         INCLUDES & PRE-PROCESSOR
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "typedef.h"
+#include "framebuffer.h"
+#include "graphics.h"
+#include "physics.h"
+#include "entity.h"
+#include "cpu_paddle.h"
+
+
+// The number of random inputs each check is given. Checking a fill tests
+// every pixel of the polygon's bounding box, so it is given fewer.
+#define CASES      200000
+#define FILL_CASES  20000
+
+// Coordinates are drawn from a margin around the screen, so clipping is
+// checked as well.
+#define MARGIN 40
+
+// How far a prediction may be from where the stepped ball crossed. Stepping
+// rounds each bounce off a wall to a fraction of a tick.
+#define PREDICT_TOLERANCE (FX_ONE / 4)
+
+// The most ticks a ball is stepped before it must have reached the paddle.
+#define PREDICT_MAX_TICKS 100000
+
+
+// =============================================================================
+//                                  STUBS
+
+// Nothing is ever flushed, so the display is never written to.
+void graphic_clear_screen(void) {}
+
+void render_queue_write_page(u8 page, u8 column, const u8 *bytes, u8 n)
+{
+    (void)page; (void)column; (void)bytes; (void)n;
+}
+
+void render_queue_submit(void) {}
+void render_queue_drain(void)  {}
+
+
+// =============================================================================
+//                                GLOBAL DATA
+
+static u32 rng_state = 1;
+
+// The framebuffer drawn by the reference version.
+static u32 expected[FB_HEIGHT][FB_WORDS];
+
+static const u32 ball_pixels[]   = { 0b0110, 0b1111, 0b1111, 0b0110 };
+static const u32 paddle_pixels[] =
+{
+    0b11111, 0b10001, 0b10001, 0b10101, 0b10101,
+    0b10101, 0b10001, 0b10001, 0b11111
+};
+
+static Sprite ball_sprite   = SPRITE(ball_pixels);
+static Sprite paddle_sprite = SPRITE(paddle_pixels);
+
+// Where the paddles stand in the game, but far below the field, so the ball
+// passes their fronts instead of bouncing off them.
+static Object left_paddle  = { &paddle_sprite, 0, 0, INT_TO_FX(10),  INT_TO_FX(200), draw_object, clear_object, NULL, NULL, 0, 0, 0, 0 };
+static Object right_paddle = { &paddle_sprite, 0, 0, INT_TO_FX(110), INT_TO_FX(200), draw_object, clear_object, NULL, NULL, 0, 0, 0, 0 };
+
+
+// =============================================================================
+//                           REFERENCE VERSIONS
+
+/**
+ * @brief The per-pixel Bresenham loop that draw_line() used to be, with int
+ *        coordinates.
+ */
+static void ref_line(int x0, int y0, int x1, int y1)
+{
+    bool steep = abs(y1 - y0) > abs(x1 - x0);
+
+    if (steep)
+    {
+        swap(&x0, &y0);
+        swap(&x1, &y1);
+    }
+
+    if (x0 > x1)
+    {
+        swap(&x0, &x1);
+        swap(&y0, &y1);
+    }
+
+    int delta_x = x1 - x0;
+    int delta_y = abs(y1 - y0);
+
+    int error = 0;
+    int y     = y0;
+
+    int y_step = y0 < y1 ? 1 : -1;
+
+    for (int x = x0; x <= x1; x++)
+    {
+        if (steep)
+            fb_pixel_set(y, x);
+        else
+            fb_pixel_set(x, y);
+
+        error += delta_y;
+        if (error >= delta_x)
+        {
+            y     += y_step;
+            error -= delta_x;
+        }
+    }
+}
+
+
+/**
+ * @brief The four lines that draw_rect() used to be.
+ */
+static void ref_rect(const Rect *rect)
+{
+    int x0 = rect->origin.x;
+    int y0 = rect->origin.y;
+    int x1 = x0 + rect->dimen.x;
+    int y1 = y0 + rect->dimen.y;
+
+    ref_line(x0, y0, x1, y0);
+    ref_line(x1, y0, x1, y1);
+    ref_line(x0, y1, x1, y1);
+    ref_line(x0, y1, x0, y0);
+}
+
+
+/**
+ * @brief fill_rect() a pixel at a time.
+ */
+static void ref_fill_rect(const Rect *rect)
+{
+    int x0 = rect->origin.x;
+    int y0 = rect->origin.y;
+    int x1 = x0 + rect->dimen.x;
+    int y1 = y0 + rect->dimen.y;
+
+    if (x0 > x1) swap(&x0, &x1);
+    if (y0 > y1) swap(&y0, &y1);
+
+    for (int y = y0; y <= y1; y++)
+        for (int x = x0; x <= x1; x++)
+            fb_pixel_set(x, y);
+}
+
+
+/**
+ * @brief draw_poly() as it used to be: a whole line per edge, so shared
+ *        vertices are drawn twice.
+ */
+static void ref_poly(const Polygon *poly)
+{
+    const Point *p = poly->points;
+    int          n = poly->count;
+
+    for (int i = 0; i + 1 < n; i++)
+        ref_line(p[i].x, p[i].y, p[i + 1].x, p[i + 1].y);
+
+    if (poly->closed)
+        ref_line(p[n - 1].x, p[n - 1].y, p[0].x, p[0].y);
+}
+
+
+/**
+ * @brief Return whether the centre of pixel (x, y) is inside a polygon, by the
+ *        even-odd rule. An edge counts for the scanlines from its top vertex
+ *        up to, but not including, its bottom one, as in fill_poly().
+ */
+static bool ref_inside(const Polygon *poly, int x, int y)
+{
+    const Point *p      = poly->points;
+    int          n      = poly->count;
+    bool         inside = false;
+
+    for (int i = 0; i < n; i++)
+    {
+        Point a = p[i];
+        Point b = p[(i + 1) % n];
+
+        if ((a.y <= y) == (b.y <= y))
+            continue;
+
+        double cross = a.x + (double)(b.x - a.x) * (y - a.y) / (b.y - a.y);
+
+        if (x < cross)
+            inside = !inside;
+    }
+
+    return inside;
+}
+
+
+// =============================================================================
+//                                 FUNCTIONS
+
+static u32 rng(void)
+{
+    // xorshift32
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+
+    return rng_state;
+}
+
+
+/**
+ * @brief A random number in [lo, hi].
+ */
+static int rng_range(int lo, int hi)
+{
+    return lo + (int)(rng() % (u32)(hi - lo + 1));
+}
+
+
+static Point random_point(void)
+{
+    return (Point){
+        rng_range(1 - MARGIN, FB_WIDTH  + MARGIN),
+        rng_range(1 - MARGIN, FB_HEIGHT + MARGIN)
+    };
+}
+
+
+/**
+ * @brief Keep what the reference version has drawn, and clear the framebuffer
+ *        for the optimized one.
+ */
+static void keep_expected(void)
+{
+    memcpy(expected, framebuffer, sizeof expected);
+    memset(framebuffer, 0, sizeof framebuffer);
+}
+
+
+/**
+ * @brief Return whether the optimized version drew the same pixels as the
+ *        reference, and clear the framebuffer for the next input.
+ */
+static bool same_as_expected(void)
+{
+    bool same = memcmp(expected, framebuffer, sizeof expected) == 0;
+
+    memset(framebuffer, 0, sizeof framebuffer);
+
+    return same;
+}
+
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+/**
+ * @brief Random lines. One in four is horizontal or vertical, which are drawn
+ *        as a single span.
+ */
+static bool check_line(bool print)
+{
+    Line line = { random_point(), random_point() };
+
+    switch (rng() & 7)
+    {
+    case 0: line.p1.y = line.p0.y; break;
+    case 1: line.p1.x = line.p0.x; break;
+    }
+
+    ref_line(line.p0.x, line.p0.y, line.p1.x, line.p1.y);
+    keep_expected();
+    draw_line(&line);
+
+    if (same_as_expected())
+        return true;
+
+    if (print)
+        printf("  line (%d, %d) - (%d, %d)\n", line.p0.x, line.p0.y, line.p1.x, line.p1.y);
+    return false;
+}
+
+
+static Rect random_rect(void)
+{
+    return (Rect){ random_point(), { rng_range(-MARGIN, MARGIN), rng_range(-MARGIN, MARGIN) } };
+}
+
+
+static bool check_rect(bool print)
+{
+    Rect rect = random_rect();
+
+    ref_rect(&rect);
+    keep_expected();
+    draw_rect(&rect);
+
+    if (same_as_expected())
+        return true;
+
+    if (print)
+        printf("  rect (%d, %d) + (%d, %d)\n", rect.origin.x, rect.origin.y, rect.dimen.x, rect.dimen.y);
+    return false;
+}
+
+
+static bool check_fill_rect(bool print)
+{
+    Rect rect = random_rect();
+
+    ref_fill_rect(&rect);
+    keep_expected();
+    fill_rect(&rect);
+
+    if (same_as_expected())
+        return true;
+
+    if (print)
+        printf("  fill_rect (%d, %d) + (%d, %d)\n", rect.origin.x, rect.origin.y, rect.dimen.x, rect.dimen.y);
+    return false;
+}
+
+
+static Point poly_points[POLY_MAX_VERTICES];
+
+/**
+ * @brief A random polygon of at least two vertices. Its edges may cross, and
+ *        one vertex in eight repeats the one before it, so some edges have
+ *        zero length.
+ */
+static Polygon random_poly(void)
+{
+    int n = rng_range(2, (rng() & 3) ? 8 : POLY_MAX_VERTICES);
+
+    for (int i = 0; i < n; i++)
+        poly_points[i] = (i > 0 && (rng() & 7) == 0) ? poly_points[i - 1] : random_point();
+
+    return (Polygon){ poly_points, n, rng() & 1 };
+}
+
+
+static void print_poly(const char *name, const Polygon *poly)
+{
+    printf("  %s%s", name, poly->closed ? "" : " open");
+    for (int i = 0; i < poly->count; i++)
+        printf(" (%d, %d)", poly->points[i].x, poly->points[i].y);
+    printf("\n");
+}
+
+
+static bool check_poly(bool print)
+{
+    Polygon poly = random_poly();
+
+    ref_poly(&poly);
+    keep_expected();
+    draw_poly(&poly);
+
+    if (same_as_expected())
+        return true;
+
+    if (print)
+        print_poly("poly", &poly);
+    return false;
+}
+
+
+/**
+ * @brief fill_poly() must cover every pixel inside the polygon and its whole
+ *        outline, and nothing outside its bounding box.
+ */
+static bool check_fill_poly(bool print)
+{
+    Polygon poly = random_poly();
+
+    poly.closed = true;
+
+    int x0 = FB_WIDTH,  x1 = 1;
+    int y0 = FB_HEIGHT, y1 = 1;
+
+    for (int i = 0; i < poly.count; i++)
+    {
+        if (poly.points[i].x < x0) x0 = poly.points[i].x;
+        if (poly.points[i].x > x1) x1 = poly.points[i].x;
+        if (poly.points[i].y < y0) y0 = poly.points[i].y;
+        if (poly.points[i].y > y1) y1 = poly.points[i].y;
+    }
+
+    ref_poly(&poly);
+    for (int y = y0 < 1 ? 1 : y0; y <= y1 && y <= FB_HEIGHT; y++)
+        for (int x = x0 < 1 ? 1 : x0; x <= x1 && x <= FB_WIDTH; x++)
+            if (ref_inside(&poly, x, y))
+                fb_pixel_set(x, y);
+    keep_expected();
+    fill_poly(&poly);
+
+    bool ok = true;
+
+    for (int y = 1; y <= FB_HEIGHT && ok; y++)
+        for (int x = 1; x <= FB_WIDTH && ok; x++)
+        {
+            bool want = (expected[y - 1][(x - 1) >> 5] >> ((x - 1) & 31)) & 1;
+            bool got  = fb_pixel_get(x, y);
+            bool box  = x >= x0 && x <= x1 && y >= y0 && y <= y1;
+
+            ok = got ? box : !want;
+        }
+
+    memset(framebuffer, 0, sizeof framebuffer);
+
+    if (ok)
+        return true;
+
+    if (print)
+        print_poly("fill_poly", &poly);
+    return false;
+}
+
+
+/**
+ * @brief Step a ball with ball_step() until it reaches the front of a paddle,
+ *        and return where its centre crossed it. The overshoot of the last
+ *        tick is taken back along the ball's direction, folded at the walls
+ *        as ball_step() would.
+ */
+static fixed ref_crossing(Body ball, P_Object paddle)
+{
+    fixed w     = INT_TO_FX(ball_sprite.width);
+    fixed h     = INT_TO_FX(ball_sprite.height);
+    bool  right = ball.dir_x > 0;
+    fixed front = right ? paddle->pos_x : paddle->pos_x + INT_TO_FX(paddle_sprite.width);
+
+    for (int tick = 0; tick < PREDICT_MAX_TICKS; tick++)
+    {
+        ball_step(&ball, &ball_sprite, &left_paddle, &right_paddle, 0);
+
+        fixed over = right ? ball.pos_x + w - front : front - ball.pos_x;
+
+        if (over < 0)
+            continue;
+
+        fixed y = ball.pos_y - (fixed)((long long)ball.dir_y * over / abs(ball.dir_x));
+
+        if (y < INT_TO_FX(FIELD_TOP))
+            y = 2 * INT_TO_FX(FIELD_TOP) - y;
+        if (y > INT_TO_FX(FIELD_BOTTOM) - h)
+            y = 2 * (INT_TO_FX(FIELD_BOTTOM) - h) - y;
+
+        return y + h / 2;
+    }
+
+    return -1;
+}
+
+
+/**
+ * @brief Random balls heading for either paddle, from anywhere between them,
+ *        at up to 3 pixels per tick across. Their angle is at most the 52.5
+ *        degrees a paddle sends them off at. ball_step() rounds every bounce
+ *        off a wall to a fraction of a tick, so steeper balls drift from the
+ *        exact path by more than the tolerance.
+ */
+static bool check_predict(bool print)
+{
+    fixed w = INT_TO_FX(ball_sprite.width);
+    fixed h = INT_TO_FX(ball_sprite.height);
+
+    fixed x0 = left_paddle.pos_x + INT_TO_FX(paddle_sprite.width);
+    fixed x1 = right_paddle.pos_x - w;
+
+    Body ball =
+    {
+        rng_range(x0, x1),
+        rng_range(INT_TO_FX(FIELD_TOP), INT_TO_FX(FIELD_BOTTOM) - h),
+        rng_range(FX_ONE / 4, 3 * FX_ONE),
+        0
+    };
+
+    // tan(52.5 degrees) is about 1.3.
+    ball.dir_y = rng_range(-ball.dir_x * 13 / 10, ball.dir_x * 13 / 10);
+
+    if (rng() & 1)
+        ball.dir_x = -ball.dir_x;
+
+    P_Object paddle = ball.dir_x > 0 ? &right_paddle : &left_paddle;
+
+    entity_clear();
+    entity_spawn(0, ball.pos_x, ball.pos_y, ball.dir_x, ball.dir_y);
+
+    fixed predicted = cpu_paddle_predict(paddle);
+    fixed stepped   = ref_crossing(ball, paddle);
+
+    if (abs(predicted - stepped) <= PREDICT_TOLERANCE)
+        return true;
+
+    if (print)
+        printf("  ball (%d, %d) dir (%d, %d): predicted %d, stepped %d (1/%d px)\n",
+            ball.pos_x, ball.pos_y, ball.dir_x, ball.dir_y, predicted, stepped, FX_ONE);
+    return false;
+}
+
+
+/**
+ * @brief A position within `spread` pixels of `centre`, in fixed-point.
+ */
+static fixed random_near(fixed centre, int spread)
+{
+    return centre + rng_range(-spread * FX_ONE, spread * FX_ONE);
+}
+
+
+/**
+ * @brief A frame as render() draws it: the balls are erased, the paddle is
+ *        drawn between ticks and the balls are drawn again. Balls are placed
+ *        on and around the paddle, which a paddle moving onto a ball can do.
+ *        The result must be the same as drawing the paddle and the balls on
+ *        an empty screen.
+ */
+static bool check_between(bool print)
+{
+    Object paddle = { &paddle_sprite, 0, 0, 0, 0, draw_object, clear_object, NULL, NULL, 0, 0, 0, 0 };
+
+    paddle.pos_x = random_near(INT_TO_FX(64), 50);
+    paddle.pos_y = random_near(INT_TO_FX(32), 25);
+
+    // The last frame, with everything drawn where it was after the tick.
+    entity_clear();
+    for (int n = rng_range(1, 3); n > 0; n--)
+        entity_spawn(0, random_near(paddle.pos_x, 5), random_near(paddle.pos_y + INT_TO_FX(2), 7), 0, 0);
+
+    draw_object(&paddle);
+    entity_draw_all(FX_ONE);
+
+    // The next tick moves the paddle by up to a pixel, and the balls by up
+    // to three.
+    paddle.prev_x = paddle.pos_x;
+    paddle.prev_y = paddle.pos_y;
+    paddle.pos_y  = random_near(paddle.pos_y, 1);
+
+    for (int i = 0; i < entities.count; i++)
+    {
+        entities.prev_x[i] = entities.pos_x[i];
+        entities.prev_y[i] = entities.pos_y[i];
+        entities.pos_x[i]  = random_near(entities.pos_x[i], 3);
+        entities.pos_y[i]  = random_near(entities.pos_y[i], 3);
+    }
+
+    fixed alpha = rng_range(0, FX_ONE);
+
+    entity_erase_all();
+    draw_object_between(&paddle, alpha);
+    entity_draw_all(alpha);
+
+    // The same frame drawn afresh, to compare with.
+    keep_expected();
+    fb_blit(
+        paddle_sprite.rows, paddle_sprite.n_rows,
+        FX_TO_INT(FX_LERP(paddle.prev_x, paddle.pos_x, alpha)),
+        FX_TO_INT(FX_LERP(paddle.prev_y, paddle.pos_y, alpha))
+    );
+    for (int i = 0; i < entities.count; i++)
+        fb_blit(
+            ball_sprite.rows, ball_sprite.n_rows,
+            FX_TO_INT(FX_LERP(entities.prev_x[i], entities.pos_x[i], alpha)),
+            FX_TO_INT(FX_LERP(entities.prev_y[i], entities.pos_y[i], alpha))
+        );
+
+    if (same_as_expected())
+        return true;
+
+    if (print)
+        printf("  paddle (%d, %d) -> (%d, %d) with %d balls, alpha %d (1/%d px)\n",
+            paddle.prev_x, paddle.prev_y, paddle.pos_x, paddle.pos_y,
+            entities.count, alpha, FX_ONE);
+    return false;
+}
+
+
+/**
+ * @brief One check. `one` compares a single random input, and prints it if
+ *        the versions differ and `print` is set.
+ */
+typedef struct
+{
+    const char *name;
+    bool      (*one)(bool print);
+    u32         cases;
+} Check;
+
+static const Check CHECKS[] =
+{
+    { "draw_line",  check_line,      CASES      },
+    { "draw_rect",  check_rect,      CASES      },
+    { "fill_rect",  check_fill_rect, CASES      },
+    { "draw_poly",  check_poly,      CASES      },
+    { "fill_poly",  check_fill_poly, FILL_CASES },
+    { "cpu_paddle_predict", check_predict, CASES },
+    { "draw_object_between", check_between, CASES },
+};
+
+
+/**
+ * @brief Run a check on its number of inputs. Only the first mismatch is printed.
+ *
+ * @return The number of mismatches.
+ */
+static u32 run(const Check *c)
+{
+    u32 mismatches = 0;
+
+    for (u32 i = 0; i < c->cases; i++)
+        if (!c->one(mismatches == 0))
+            mismatches++;
+
+    printf("check=%s cases=%u mismatches=%u\n", c->name, c->cases, mismatches);
+
+    return mismatches;
+}
+
+
+int main(void)
+{
+    const char *seed = getenv("PONG_SEED");
+
+    rng_state = seed ? (u32)strtoul(seed, NULL, 10) : 1;
+    if (rng_state == 0)
+        rng_state = 1;
+
+    sprite_init(&ball_sprite);
+    sprite_init(&paddle_sprite);
+    entity_add_sprite(&ball_sprite);
+
+    u32 failed = 0;
+
+    for (u32 i = 0; i < sizeof CHECKS / sizeof CHECKS[0]; i++)
+        failed += run(&CHECKS[i]) > 0;
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,559 @@
+/*
+ * A headless tournament: thousands of complete matches of the game logic in
+ * src/match.c, played natively on every core, for tuning the rules and as a
+ * throughput benchmark of the simulation.
+ *
+ * Build and run with `make tournament`. Each player is either the computer
+ * opponent of src/cpu_paddle.c or a simple script. The tournament is
+ * configured with environment variables:
+ *
+ *   PONG_MATCHES       The number of matches (default 10000).
+ *   PONG_JOBS          The number of threads (default one per core).
+ *   PONG_MODE          `classic` or `multiball` (default classic).
+ *   PONG_BALL_SPEED    The speed of the ball, in pixels per second (150).
+ *   PONG_PADDLE_SPEED  The speed of the paddles, in pixels per second (60).
+ *   PONG_MAX_SCORE     The points needed to win (3).
+ *   PONG_LEFT          How the left paddle is played: `cpu`, `track`, which
+ *                      follows the ball without predicting, or `idle`.
+ *                      Defaults to track, standing in for a player.
+ *   PONG_RIGHT         The same for the right paddle. Defaults to cpu, as
+ *                      when the game is started with key 4.
+ *   PONG_REACTION      Reaction time of `cpu` players, in frames (8).
+ *   PONG_ERROR         Aiming error of `cpu` players, in pixels (9).
+ *   PONG_MAX_FRAMES    Frames after which a match is abandoned (36000, ten
+ *                      minutes of play).
+ *   PONG_MAX_RALLY     Paddle hits after which a round, and its match, is
+ *                      abandoned (200).
+ *
+ * With the defaults the computer wins about three matches in four. Players
+ * that never miss, such as `cpu` with an error below 7, can rally forever;
+ * their matches are cut short by the limits and counted as abandoned rather
+ * than won. The ball is always served to the right, so two players of the
+ * same kind don't win equally often.
+ *
+ * Match `n` is seeded with `n` whichever thread plays it, so the results only
+ * depend on the configuration. They are printed as key=value lines, followed
+ * by the distributions of the final scores of the matches that were won and
+ * of the paddle hits per round that was finished:
+ *
+ *   score=<left>-<right> count=<n>
+ *   rally=<hits> count=<n>
+ *
+ * Matches take very different amounts of time, so each thread starts with an
+ * equal share of them and steals half of another thread's remaining share
+ * when it runs out.
+ */
+
+// =============================================================================
+//                         INCLUDES & PRE-PROCESSOR
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "typedef.h"
+#include "display_driver.h"
+#include "entity.h"
+#include "match.h"
+#include "cpu_paddle.h"
+#include "graphics.h"
+#include "physics.h"
+
+
+// The most threads that are started.
+#define MAX_JOBS 256
+
+// The highest `PONG_MAX_SCORE`, which bounds the score distribution.
+#define SCORE_LIMIT 15
+
+// Rallies longer than this are counted together.
+#define RALLY_LIMIT 255
+
+typedef unsigned long long u64;
+
+
+// =============================================================================
+//                                  STUBS
+
+// Nothing is drawn, but entity.c can draw into the framebuffer.
+void graphic_clear_screen(void) {}
+
+void render_queue_write_page(u8 page, u8 column, const u8 *bytes, u8 n)
+{
+    (void)page; (void)column; (void)bytes; (void)n;
+}
+
+void render_queue_submit(void) {}
+void render_queue_drain(void)  {}
+
+
+// =============================================================================
+//                                GLOBAL DATA
+
+/**
+ * @brief How a paddle is played.
+*/
+typedef enum
+{
+    PLAY_CPU,       // Aims for the predicted intercept, see cpu_paddle.h.
+    PLAY_TRACK,     // Follows the first ball.
+    PLAY_IDLE       // Never moves.
+} Play;
+
+
+/**
+ * @brief The configuration of the tournament.
+*/
+typedef struct
+{
+    u32        matches;
+    u32        jobs;
+    MatchRules rules;
+    Play       play[2];         // Left and right.
+    u8         reaction_frames;
+    u8         error_px;
+    u32        max_frames;
+    u32        max_rally;
+} Config;
+
+static Config config;
+
+
+/**
+ * @brief The results of the matches a thread has played. Summed once all
+ *        threads are done.
+*/
+typedef struct
+{
+    u64 matches;
+    u64 frames;
+    u64 rounds;
+    u64 wins[2];            // Left and right.
+    u64 abandoned;
+    u64 frames_max;
+    u64 score[SCORE_LIMIT + 1][SCORE_LIMIT + 1];
+    u64 rally[RALLY_LIMIT + 1];
+    u64 rally_hits;
+    u64 rally_max;
+    u64 steals;
+} Results;
+
+
+/**
+ * @brief A thread and the matches it has yet to play, [next, end). Both are
+ *        changed by thieves, so they are only touched with `lock` held.
+*/
+typedef struct
+{
+    pthread_t       thread;
+    pthread_mutex_t lock;
+    u32             next;
+    u32             end;
+    u32             id;
+    Results         results;
+} Worker;
+
+static Worker workers[MAX_JOBS];
+
+
+static const u32 ball_pixels[]   = { 0b0110, 0b1111, 0b1111, 0b0110 };
+static const u32 paddle_pixels[] =
+{
+    0b11111, 0b10001, 0b10001, 0b10101, 0b10101,
+    0b10101, 0b10001, 0b10001, 0b11111
+};
+
+// Read-only once initialized, so they are shared by all threads.
+static Sprite ball_sprite   = SPRITE(ball_pixels);
+static Sprite paddle_sprite = SPRITE(paddle_pixels);
+
+
+// =============================================================================
+//                                 PLAYERS
+
+// The paddles are moved without being drawn.
+static void move_paddle(P_Object paddle)
+{
+    paddle->pos_x += paddle->dir_x;
+    paddle->pos_y += paddle->dir_y;
+}
+
+
+static void set_paddle_speed(P_Object paddle, fixed speed_x, fixed speed_y)
+{
+    paddle->dir_x = speed_x;
+    paddle->dir_y = speed_y;
+}
+
+
+/**
+ * @brief Follow the centre of the first ball, as a player who doesn't think
+ *        ahead would.
+ */
+static i8 track_ball(P_Object paddle)
+{
+    if (entities.count == 0)
+        return 0;
+
+    P_Sprite ball   = entity_sprite(entities.sprite[0]);
+    fixed    ball_y = entities.pos_y[0] + INT_TO_FX(ball->height) / 2;
+    fixed    centre = paddle->pos_y + INT_TO_FX(paddle->sprite->height) / 2;
+
+    if (ball_y > centre + INT_TO_FX(1)) return  1;
+    if (ball_y < centre - INT_TO_FX(1)) return -1;
+    return 0;
+}
+
+
+/**
+ * @brief Seed the computer players of a round. Mixes in the match, the side
+ *        and the score, so that every round plays out differently.
+ */
+static u32 round_seed(u32 match_id, int side, P_Match match)
+{
+    u32 score = match->left->points + (match->right->points << 8);
+
+    return 1 + (match_id << 17) + ((u32)side << 16) + score;
+}
+
+
+// =============================================================================
+//                                 MATCHES
+
+/**
+ * @brief Play a match to the end and add its outcome to the results.
+ */
+static void play_match(u32 match_id, u8 ball_sprite_id, Results *results)
+{
+    Object paddles[2] =
+    {
+        { &paddle_sprite, 0, 0, 0, 0, NULL, NULL, move_paddle, set_paddle_speed, 0, 0, 0, 0 },
+        { &paddle_sprite, 0, 0, 0, 0, NULL, NULL, move_paddle, set_paddle_speed, 0, 0, 0, 0 },
+    };
+    Player players[2] =
+    {
+        { "Left",  0, 0, &paddles[0] },
+        { "Right", 0, 0, &paddles[1] },
+    };
+
+    Match     match;
+    CpuPaddle cpu[2];
+    u64       frames = 0;
+
+    match_init(&match, &config.rules, &players[0], &players[1], ball_sprite_id);
+
+    while (!match_winner(&match) && frames < config.max_frames)
+    {
+        match_new_round(&match);
+
+        for (int side = 0; side < 2; side++)
+            cpu_paddle_init(
+                &cpu[side], &paddles[side], config.reaction_frames,
+                config.error_px, round_seed(match_id, side, &match)
+            );
+
+        MatchState state = MATCH_PLAYING;
+
+        while (state == MATCH_PLAYING && frames < config.max_frames
+               && match.rally < config.max_rally)
+        {
+            i8 dy[2];
+
+            for (int side = 0; side < 2; side++)
+            {
+                switch (config.play[side])
+                {
+                    case PLAY_CPU:   dy[side] = cpu_paddle_update(&cpu[side]); break;
+                    case PLAY_TRACK: dy[side] = track_ball(&paddles[side]);    break;
+                    default:         dy[side] = 0;                             break;
+                }
+            }
+
+            state = match_frame(&match, dy[0], dy[1], 1);
+            frames++;
+        }
+
+        // An abandoned round didn't end, so its rally isn't counted.
+        if (state == MATCH_PLAYING)
+            break;
+
+        u32 rally = match.rally < RALLY_LIMIT ? match.rally : RALLY_LIMIT;
+
+        results->rounds++;
+        results->rally[rally]++;
+        results->rally_hits += match.rally;
+        if (match.rally > results->rally_max)
+            results->rally_max = match.rally;
+    }
+
+    P_Player winner = match_winner(&match);
+
+    results->matches++;
+    results->frames += frames;
+    if (frames > results->frames_max)
+        results->frames_max = frames;
+
+    // An abandoned match has no final score.
+    if (!winner)
+    {
+        results->abandoned++;
+        return;
+    }
+
+    results->wins[winner == &players[1]]++;
+
+    // A multiball round can score more than the points needed to win.
+    u32 left  = players[0].points < SCORE_LIMIT ? players[0].points : SCORE_LIMIT;
+    u32 right = players[1].points < SCORE_LIMIT ? players[1].points : SCORE_LIMIT;
+
+    results->score[left][right]++;
+}
+
+
+// =============================================================================
+//                               WORK STEALING
+
+/**
+ * @brief Take the next match of a worker's own share.
+ *
+ * @return false if the share is empty.
+ */
+static bool take(Worker *w, u32 *match_id)
+{
+    pthread_mutex_lock(&w->lock);
+
+    bool found = w->next < w->end;
+    if (found)
+        *match_id = w->next++;
+
+    pthread_mutex_unlock(&w->lock);
+    return found;
+}
+
+
+/**
+ * @brief Move the back half of another worker's share to an empty worker.
+ *        Victims are tried in turn, starting with the next worker.
+ *
+ * @return false if every share is empty, which means the tournament is over.
+ */
+static bool steal(Worker *thief)
+{
+    for (u32 i = 1; i < config.jobs; i++)
+    {
+        Worker *victim = &workers[(thief->id + i) % config.jobs];
+
+        pthread_mutex_lock(&victim->lock);
+
+        u32 left = victim->end - victim->next;
+        u32 n    = (left + 1) / 2;
+        u32 end  = victim->end;
+        victim->end -= n;
+
+        pthread_mutex_unlock(&victim->lock);
+
+        if (n == 0)
+            continue;
+
+        pthread_mutex_lock(&thief->lock);
+        thief->next = end - n;
+        thief->end  = end;
+        pthread_mutex_unlock(&thief->lock);
+
+        thief->results.steals++;
+        return true;
+    }
+
+    return false;
+}
+
+
+static void *work(void *arg)
+{
+    Worker *w = arg;
+
+    // The entity store and its sprite table belong to this thread.
+    int ball_sprite_id = entity_add_sprite(&ball_sprite);
+
+    u32 match_id;
+    while (take(w, &match_id) || (steal(w) && take(w, &match_id)))
+        play_match(match_id, ball_sprite_id, &w->results);
+
+    return NULL;
+}
+
+
+// =============================================================================
+//                                 REPORT
+
+static void add_results(Results *sum, const Results *add)
+{
+    sum->matches    += add->matches;
+    sum->frames     += add->frames;
+    sum->rounds     += add->rounds;
+    sum->wins[0]    += add->wins[0];
+    sum->wins[1]    += add->wins[1];
+    sum->abandoned  += add->abandoned;
+    sum->rally_hits += add->rally_hits;
+    sum->steals     += add->steals;
+
+    if (add->frames_max > sum->frames_max) sum->frames_max = add->frames_max;
+    if (add->rally_max  > sum->rally_max)  sum->rally_max  = add->rally_max;
+
+    for (int l = 0; l <= SCORE_LIMIT; l++)
+        for (int r = 0; r <= SCORE_LIMIT; r++)
+            sum->score[l][r] += add->score[l][r];
+
+    for (int i = 0; i <= RALLY_LIMIT; i++)
+        sum->rally[i] += add->rally[i];
+}
+
+
+/**
+ * @brief The rally length that the given fraction of rounds don't exceed.
+ */
+static u32 rally_percentile(const Results *r, double fraction)
+{
+    u64 seen = 0;
+
+    for (u32 i = 0; i <= RALLY_LIMIT; i++)
+    {
+        seen += r->rally[i];
+        if (seen >= fraction * r->rounds)
+            return i;
+    }
+
+    return RALLY_LIMIT;
+}
+
+
+static void report(const Results *r, double wall_s)
+{
+    static const char *PLAY_NAMES[] = { "cpu", "track", "idle" };
+
+    printf("matches=%llu\n",         r->matches);
+    printf("jobs=%u\n",              config.jobs);
+    printf("mode=%s\n",              config.rules.mode == MODE_MULTIBALL ? "multiball" : "classic");
+    printf("left=%s\n",              PLAY_NAMES[config.play[0]]);
+    printf("right=%s\n",             PLAY_NAMES[config.play[1]]);
+    printf("wall_ms=%.3f\n",         wall_s * 1e3);
+    printf("matches_per_sec=%.0f\n", r->matches / wall_s);
+    printf("frames_per_sec=%.0f\n",  r->frames  / wall_s);
+    printf("steals=%llu\n",          r->steals);
+    printf("left_wins=%llu\n",       r->wins[0]);
+    printf("right_wins=%llu\n",      r->wins[1]);
+    printf("abandoned=%llu\n",       r->abandoned);
+    printf("frames_mean=%.1f\n",     r->matches ? (double)r->frames / r->matches : 0.0);
+    printf("frames_max=%llu\n",      r->frames_max);
+    printf("rounds=%llu\n",          r->rounds);
+    printf("rally_mean=%.2f\n",      r->rounds ? (double)r->rally_hits / r->rounds : 0.0);
+    printf("rally_p50=%u\n",         rally_percentile(r, 0.50));
+    printf("rally_p90=%u\n",         rally_percentile(r, 0.90));
+    printf("rally_p99=%u\n",         rally_percentile(r, 0.99));
+    printf("rally_max=%llu\n",       r->rally_max);
+
+    for (int left = 0; left <= SCORE_LIMIT; left++)
+        for (int right = 0; right <= SCORE_LIMIT; right++)
+            if (r->score[left][right])
+                printf("score=%d-%d count=%llu\n", left, right, r->score[left][right]);
+
+    for (int i = 0; i <= RALLY_LIMIT; i++)
+        if (r->rally[i])
+            printf("rally=%d%s count=%llu\n", i, i == RALLY_LIMIT ? "+" : "", r->rally[i]);
+}
+
+
+// =============================================================================
+//                               CONFIGURATION
+
+static u32 env_u32(const char *name, u32 fallback)
+{
+    const char *s = getenv(name);
+    return s ? (u32)strtoul(s, NULL, 10) : fallback;
+}
+
+
+static Play env_play(const char *name, Play fallback)
+{
+    const char *s = getenv(name);
+
+    if (!s)                          return fallback;
+    if (strcmp(s, "cpu") == 0)       return PLAY_CPU;
+    if (strcmp(s, "track") == 0)     return PLAY_TRACK;
+    if (strcmp(s, "idle") == 0)      return PLAY_IDLE;
+
+    fprintf(stderr, "tournament: unknown player '%s' in %s\n", s, name);
+    exit(1);
+}
+
+
+static void configure(void)
+{
+    const char *mode = getenv("PONG_MODE");
+    long        cores = sysconf(_SC_NPROCESSORS_ONLN);
+
+    config.matches         = env_u32("PONG_MATCHES", 10000);
+    config.jobs            = env_u32("PONG_JOBS", cores > 0 ? cores : 1);
+    config.play[0]         = env_play("PONG_LEFT",  PLAY_TRACK);
+    config.play[1]         = env_play("PONG_RIGHT", PLAY_CPU);
+    config.reaction_frames = env_u32("PONG_REACTION", 8);
+    config.error_px        = env_u32("PONG_ERROR", 9);
+    config.max_frames      = env_u32("PONG_MAX_FRAMES", 10 * 60 * TICK_HZ);
+    config.max_rally       = env_u32("PONG_MAX_RALLY", 200);
+
+    config.rules.mode         = mode && strcmp(mode, "multiball") == 0 ? MODE_MULTIBALL : MODE_CLASSIC;
+    config.rules.ball_speed   = INT_TO_FX(env_u32("PONG_BALL_SPEED", 150)) / TICK_HZ;
+    config.rules.paddle_speed = INT_TO_FX(env_u32("PONG_PADDLE_SPEED", 60)) / TICK_HZ;
+    config.rules.max_score    = env_u32("PONG_MAX_SCORE", MAX_SCORE);
+
+    if (config.jobs < 1)        config.jobs = 1;
+    if (config.jobs > MAX_JOBS) config.jobs = MAX_JOBS;
+
+    if (config.rules.max_score < 1)           config.rules.max_score = 1;
+    if (config.rules.max_score > SCORE_LIMIT) config.rules.max_score = SCORE_LIMIT;
+}
+
+
+int main(void)
+{
+    configure();
+
+    sprite_init(&ball_sprite);
+    sprite_init(&paddle_sprite);
+
+    // Deal the matches out in equal shares.
+    for (u32 i = 0; i < config.jobs; i++)
+    {
+        Worker *w = &workers[i];
+
+        w->id   = i;
+        w->next = (u64)config.matches *  i      / config.jobs;
+        w->end  = (u64)config.matches * (i + 1) / config.jobs;
+        pthread_mutex_init(&w->lock, NULL);
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (u32 i = 0; i < config.jobs; i++)
+        pthread_create(&workers[i].thread, NULL, work, &workers[i]);
+
+    Results sum;
+    memset(&sum, 0, sizeof sum);
+
+    for (u32 i = 0; i < config.jobs; i++)
+    {
+        pthread_join(workers[i].thread, NULL);
+        add_results(&sum, &workers[i].results);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    double wall_s = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    report(&sum, wall_s);
+
+    return 0;
+}
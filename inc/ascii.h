@@ -3,14 +3,18 @@
 
 #include "typedef.h"
 
-void ascii_ctrl_bit_set(u8 x);
-void ascii_ctrl_bit_clear(u8 x);
-void ascii_write_controller(u8 byte);
-u8 ascii_read_controller();
-void ascii_goto(u32 row, u32 column);
-void ascii_write_char(u8 c);
+// The text display is part of the hardware abstraction layer (see hal.h).
+// Every backend implements the functions below. Text is normally sent through
+// the queue in ascii_queue.h, which uses the non-blocking functions.
+
+// Blocking: wait for the controller before and after each instruction.
 void ascii_init(void);
 void ascii_command(u8 cmd, void(*delay_func)(u32), u32 delay_dur);
 void ascii_data(u8 cmd, void(*delay_func)(u32), u32 delay_dur);
 
-#endif // __ASCII_H__
\ No newline at end of file
+// Non-blocking: only valid when ascii_busy() returns false.
+bool ascii_busy(void);
+void ascii_write_cmd(u8 cmd);
+void ascii_write_data(u8 data);
+
+#endif // __ASCII_H__
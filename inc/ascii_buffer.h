@@ -0,0 +1,55 @@
+#ifndef __ASCII_BUFFER_H__
+#define __ASCII_BUFFER_H__
+
+#include "typedef.h"
+
+
+// The dimensions of the text display, in characters.
+#define ASCII_COLUMNS 20
+#define ASCII_ROWS     2
+
+
+/**
+ * @brief Reset the shadow buffer to a blank screen. Call this right after
+ *        ascii_init(), when the display is known to be blank.
+*/
+void ascii_buf_init(void);
+
+
+/**
+ * @brief Blank the whole buffer. Nothing is sent until the next flush.
+*/
+void ascii_buf_clear(void);
+
+
+/**
+ * @brief Move the buffer's cursor. Uses the same coordinates as ascii_goto().
+ *
+ * @param x    An integer in range [1, 20]
+ * @param line An integer in range [1, 2]
+*/
+void ascii_buf_goto(u32 x, u32 line);
+
+
+/**
+ * @brief Write a character at the cursor and advance it. Characters past the
+ *        end of the line are dropped.
+*/
+void ascii_buf_putc(u8 c);
+
+
+/**
+ * @brief Write a string at the cursor.
+*/
+void ascii_buf_puts(const char *s);
+
+
+/**
+ * @brief Queue the characters that differ from what the display is showing.
+ *        A goto is only issued at the start of each run of changed cells.
+ *        The queue is sent in the background, see ascii_queue.h.
+*/
+void ascii_buf_flush(void);
+
+
+#endif // __ASCII_BUFFER_H__
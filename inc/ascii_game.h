@@ -3,7 +3,6 @@
 
 #include "graphics.h"
 
-void ascii_draw_score(P_Player p);
 void ascii_draw_name(P_Player p);
 void ascii_init_game (P_Player p1, P_Player p2);
 void ascii_player_wins(P_Player p);
@@ -0,0 +1,55 @@
+#ifndef __ASCII_QUEUE_H__
+#define __ASCII_QUEUE_H__
+
+#include "typedef.h"
+
+
+// The number of commands and characters that can wait to be sent. Must be a
+// power of two.
+#define ASCII_QUEUE_SIZE 64
+
+// How long the controller takes to execute an instruction, in microseconds.
+// Clear Display and Return Home take much longer than everything else.
+#define ASCII_EXEC_US       43
+#define ASCII_EXEC_SLOW_US  1530
+
+
+/**
+ * @brief Start draining the queue from the ticker's interrupt. The display
+ *        must have been set up with ascii_init(), and the ticker must be
+ *        running.
+*/
+void ascii_queue_init(void);
+
+
+/**
+ * @brief Queue a move of the display's cursor. Returns at once, unless the
+ *        queue is full.
+ *
+ * @param row    An integer in range [1, 20]
+ * @param column An integer in range [1, 2]
+*/
+void ascii_goto(u32 row, u32 column);
+
+
+/**
+ * @brief Queue a character for the display. Returns at once, unless the queue
+ *        is full.
+*/
+void ascii_write_char(u8 c);
+
+
+/**
+ * @brief Send the next queued entry, if the controller is ready for it. Called
+ *        from the ticker's interrupt by ascii_queue_init().
+*/
+void ascii_queue_pump(void);
+
+
+/**
+ * @brief Return the number of entries that have not been sent yet.
+*/
+u32 ascii_queue_pending(void);
+
+
+#endif // __ASCII_QUEUE_H__
@@ -0,0 +1,37 @@
+#ifndef __CLOCK_H__
+#define __CLOCK_H__
+
+#include "typedef.h"
+
+
+/**
+ * @brief Start the free-running clock and measure its rate. Called by
+ *        app_init(). Part of the hardware abstraction layer.
+*/
+void clock_init(void);
+
+
+/**
+ * @brief Return the free-running clock, in ticks. It wraps around, so compare
+ *        two readings by their signed difference. Part of the hardware
+ *        abstraction layer.
+*/
+u32 now(void);
+
+
+/**
+ * @brief Return the number of ticks of now() per microsecond, as measured by
+ *        clock_init(). Part of the hardware abstraction layer.
+*/
+u32 clock_ticks_per_us(void);
+
+
+/**
+ * @brief Block until now() has reached `deadline`. Deadlines more than 2^31
+ *        ticks away are treated as already passed. Part of the hardware
+ *        abstraction layer.
+*/
+void delay_until(u32 deadline);
+
+
+#endif // __CLOCK_H__
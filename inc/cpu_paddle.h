@@ -0,0 +1,71 @@
+#ifndef __CPU_PADDLE_H__
+#define __CPU_PADDLE_H__
+
+#include "typedef.h"
+#include "fixed.h"
+#include "graphics.h"
+
+
+/**
+ * @brief A paddle steered by the computer. It follows the first ball of the
+ *        entity store, aiming for where the ball will cross the paddle.
+ *
+ *        The crossing point is predicted analytically, walls included, and
+ *        cached. It is only predicted again once the ball changes velocity,
+ *        which happens at paddle and wall bounces, or when balls are added or
+ *        removed. Every other frame costs a few comparisons.
+*/
+typedef struct
+{
+    P_Object paddle;            // The paddle to steer.
+    u8       reaction_frames;   // Frames before a new prediction is acted on.
+    u8       error_px;          // The most the aim is off by, in pixels.
+
+    // The prediction, and what it was made from.
+    fixed    seen_dir_x;
+    fixed    seen_dir_y;
+    int      seen_count;
+    fixed    next_target;       // Aimed for once `delay` runs out.
+    fixed    target;            // Aimed for now, as the centre of the paddle.
+    u8       delay;
+    u32      seed;              // For the aiming error.
+} CpuPaddle, *P_CpuPaddle;
+
+
+/**
+ * @brief Take control of a paddle. The paddle waits in the middle of the
+ *        field until there is a ball to follow.
+ *
+ * @param reaction_frames Frames between the ball changing course and the
+ *                        paddle reacting to it.
+ * @param error_px        The aim is off by up to this many pixels, chosen
+ *                        anew with every prediction.
+ * @param seed            Seeds the aiming error, so a match can be replayed.
+*/
+void cpu_paddle_init(
+    P_CpuPaddle cpu,
+    P_Object    paddle,
+    u8          reaction_frames,
+    u8          error_px,
+    u32         seed
+);
+
+
+/**
+ * @brief Decide which way to move the paddle. Call once per frame.
+ *
+ * @return -1 to move up, 1 to move down or 0 to stay, in the same way as a
+ *         player's keys.
+*/
+i8 cpu_paddle_update(P_CpuPaddle cpu);
+
+
+/**
+ * @brief Predict where the centre of the first ball will be when it reaches
+ *        the front of a paddle, after bouncing off the walls on the way. A
+ *        ball moving away gives the middle of the field.
+*/
+fixed cpu_paddle_predict(P_Object paddle);
+
+
+#endif // __CPU_PADDLE_H__
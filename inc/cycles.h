@@ -0,0 +1,28 @@
+#ifndef __CYCLES_H__
+#define __CYCLES_H__
+
+#include "typedef.h"
+
+
+/**
+ * @brief Start the cycle counter. Part of the hardware abstraction layer.
+*/
+void cycles_init(void);
+
+
+/**
+ * @brief Return the free-running cycle counter. It wraps around, so only the
+ *        difference between two readings is meaningful. Part of the hardware
+ *        abstraction layer.
+*/
+u32 cycles_now(void);
+
+
+/**
+ * @brief Return the number of counts per microsecond of cycles_now(). Part of
+ *        the hardware abstraction layer.
+*/
+u32 cycles_per_us(void);
+
+
+#endif // __CYCLES_H__
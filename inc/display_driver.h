@@ -1,6 +1,15 @@
 #ifndef __DISPLAY_DRIVER_H__
 #define __DISPLAY_DRIVER_H__
 
+#include "typedef.h"
+
+// The graphic display, driven through the KS0108 bus of ks0108.h. Pixel
+// coordinates are x in [1, 128] and y in [1, 64].
+
+
+// The display is written in pages of 8 rows.
+#define GRAPHIC_PAGES 8
+
 
 void graphic_initialize   (void);
 void graphic_clear_screen (void);
@@ -8,4 +17,17 @@ void graphic_pixel_set    (int, int);
 void graphic_pixel_clear  (int, int);
 
 
-#endif // __DISPLAY_DRIVER_H__
\ No newline at end of file
+/**
+ * @brief Write a run of column bytes into one page of the display, starting at
+ *        a column in [0, 127]. The address is only sent where the controller
+ *        doesn't already point at the column, so consecutive runs cost one
+ *        bus cycle per byte.
+ *
+ *        Writing a page is much cheaper than setting its pixels one by one.
+ *        A pixel costs up to six bus cycles, to address, read and write back
+ *        the byte it is in.
+*/
+void graphic_write_page(u8 page, u8 column, const u8 *bytes, u8 n);
+
+
+#endif // __DISPLAY_DRIVER_H__
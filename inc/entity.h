@@ -0,0 +1,93 @@
+#ifndef __ENTITY_H__
+#define __ENTITY_H__
+
+#include "typedef.h"
+#include "fixed.h"
+#include "graphics.h"
+
+
+// The most entities the store can hold.
+#define ENTITY_MAX 256
+
+// The most sprites entities can be drawn with.
+#define ENTITY_SPRITES 8
+
+
+/**
+ * @brief All moving entities, as a structure of arrays. Entity `i` is made up
+ *        of element `i` of every array, and entities 0 to count - 1 are in
+ *        use. Loops over a single property touch nothing else.
+ *
+ *        Removing an entity moves the last one into its place, so ids are
+ *        only stable until the next entity_remove().
+*/
+typedef struct
+{
+    int   count;
+    fixed pos_x[ENTITY_MAX];    // Position, in fixed-point pixels.
+    fixed pos_y[ENTITY_MAX];
+    fixed dir_x[ENTITY_MAX];    // Velocity, in fixed-point pixels per tick.
+    fixed dir_y[ENTITY_MAX];
+    fixed prev_x[ENTITY_MAX];   // Position before the last tick, which the
+    fixed prev_y[ENTITY_MAX];   // entity is drawn between.
+    u8    sprite[ENTITY_MAX];   // Index into the sprite table.
+    i16   drawn_x[ENTITY_MAX];  // Where the entity is in the framebuffer,
+    i16   drawn_y[ENTITY_MAX];  // in whole pixels.
+} EntityStore;
+
+extern THREAD_LOCAL EntityStore entities;
+
+
+/**
+ * @brief Add a sprite to the table entities are drawn from.
+ *
+ * @return The sprite id, or -1 if the table is full.
+*/
+int entity_add_sprite(P_Sprite sprite);
+
+
+/**
+ * @brief Return the sprite with the given id.
+*/
+P_Sprite entity_sprite(u8 id);
+
+
+/**
+ * @brief Remove all entities. They are not erased from the framebuffer.
+*/
+void entity_clear(void);
+
+
+/**
+ * @brief Add an entity. It is drawn by the next entity_draw_all().
+ *
+ * @return The id of the entity, or -1 if the store is full.
+*/
+int entity_spawn(u8 sprite, fixed x, fixed y, fixed dx, fixed dy);
+
+
+/**
+ * @brief Remove an entity. It is not erased, so call this between
+ *        entity_erase_all() and entity_draw_all().
+*/
+void entity_remove(int id);
+
+
+/**
+ * @brief Erase every entity from the framebuffer, where it was last drawn.
+ *        Together with entity_draw_all(), overlapping entities can't erase
+ *        each other's pixels.
+*/
+void entity_erase_all(void);
+
+
+/**
+ * @brief Draw every entity into the framebuffer, between its position before
+ *        the last tick and its current one.
+ *
+ * @param alpha How far between the positions, from 0 to FX_ONE.
+*/
+void entity_draw_all(fixed alpha);
+
+
+#endif // __ENTITY_H__
@@ -0,0 +1,29 @@
+#ifndef __FIXED_H__
+#define __FIXED_H__
+
+#include "typedef.h"
+
+
+/**
+ * @brief A signed Q23.8 fixed-point number: the low FX_SHIFT bits are the
+ *        fraction. Used for sub-pixel positions and velocities.
+*/
+typedef i32 fixed;
+
+#define FX_SHIFT 8
+#define FX_ONE   (1 << FX_SHIFT)
+
+// Convert a whole number to fixed-point.
+#define INT_TO_FX(i) ((fixed)(i) * FX_ONE)
+
+// Round a fixed-point number to the nearest whole number.
+#define FX_TO_INT(f) (((f) + (FX_ONE >> 1)) >> FX_SHIFT)
+
+// Multiply two fixed-point numbers. The product must fit in 32 bits.
+#define FX_MUL(a, b) (((a) * (b)) >> FX_SHIFT)
+
+// The point a fraction t of the way from a to b, with t in [0, FX_ONE].
+#define FX_LERP(a, b, t) ((a) + FX_MUL((b) - (a), (t)))
+
+
+#endif // __FIXED_H__
@@ -0,0 +1,50 @@
+#ifndef __FONT_H__
+#define __FONT_H__
+
+#include "typedef.h"
+
+
+/**
+ * @brief A bitmap font for the graphic display. The glyphs are one bit per
+ *        pixel, stored as const data, and cover a contiguous range of
+ *        characters.
+*/
+typedef struct
+{
+    const u8 *glyphs;   // `height` row masks per glyph, top row first. Bit `n`
+                        // is the pixel `n` steps to the right of the left edge.
+    u8        width;    // The width of every glyph, at most 8.
+    u8        height;   // The height of every glyph.
+    u8        spacing;  // Blank columns between two glyphs.
+    char      first;    // The character of the first glyph.
+    u8        count;    // The number of glyphs.
+} Font;
+
+
+// Upper case letters, digits and punctuation, 3x5 pixels. Lower case letters
+// are drawn in upper case.
+extern const Font font_small;
+
+// Digits only, 6x10 pixels, for the scores.
+extern const Font font_digits;
+
+
+/**
+ * @brief Return the width of a string in pixels, without trailing spacing.
+*/
+int font_text_width(const Font *font, const char *text);
+
+
+/**
+ * @brief Draw a string into the framebuffer with its top-left corner at (x, y),
+ *        in the coordinates of fb_pixel_set(). Each row of the string is put
+ *        together in a line of words first, then written over the framebuffer
+ *        in one go, so the text needs no erasing before it is changed.
+ *        Characters the font doesn't have are drawn blank.
+ *
+ * @return The width of the string in pixels.
+*/
+int font_draw(const Font *font, const char *text, int x, int y);
+
+
+#endif // __FONT_H__
@@ -0,0 +1,122 @@
+#ifndef __FRAMEBUFFER_H__
+#define __FRAMEBUFFER_H__
+
+#include "typedef.h"
+
+
+// The dimensions of the graphic display, in pixels.
+#define FB_WIDTH  128
+#define FB_HEIGHT  64
+
+// The number of 32-bit words that make up one row of the framebuffer.
+#define FB_WORDS (FB_WIDTH / 32)
+
+
+/**
+ * @brief The off-screen image of the graphic display. One bit per pixel, one
+ *        row of `FB_WORDS` words per scanline. Bit `n` of a word is the pixel
+ *        `n` steps to the right of the word's first pixel.
+ *
+ *        Coordinates passed to the fb_* functions use the same convention as
+ *        graphic_pixel_set(), i.e. x in [1, 128] and y in [1, 64]. Pixels
+ *        outside of the screen are silently ignored.
+*/
+extern u32 framebuffer[FB_HEIGHT][FB_WORDS];
+
+
+/**
+ * @brief Clear the framebuffer and the physical screen.
+*/
+void fb_clear(void);
+
+
+/**
+ * @brief Turn on a pixel in the framebuffer.
+ *
+ * @return 1 if the pixel is inside the screen, 0 otherwise.
+*/
+int fb_pixel_set(int x, int y);
+
+
+/**
+ * @brief Turn off a pixel in the framebuffer.
+ *
+ * @return 1 if the pixel is inside the screen, 0 otherwise.
+*/
+int fb_pixel_clear(int x, int y);
+
+
+/**
+ * @brief Return whether a pixel in the framebuffer is turned on.
+*/
+bool fb_pixel_get(int x, int y);
+
+
+/**
+ * @brief Turn on every pixel of a rectangle, a whole word of a row at a time.
+ *        The corners are included and may be given in any order.
+ *
+ * @return The number of pixels inside the screen.
+*/
+int fb_fill_rect(int x0, int y0, int x1, int y1);
+
+
+/**
+ * @brief Turn on the pixels from x0 to x1 of row y. See fb_fill_rect().
+*/
+int fb_hspan(int x0, int x1, int y);
+
+
+/**
+ * @brief Turn on the pixels from y0 to y1 of column x. See fb_fill_rect().
+*/
+int fb_vspan(int x, int y0, int y1);
+
+
+/**
+ * @brief Turn on the set pixels of a bitmap, whole words at a time.
+ *
+ * @param rows   One mask per row. Bit `n` is the pixel `n` steps to the right
+ *               of (x, y).
+ * @param n_rows The number of rows.
+*/
+void fb_blit(const u32 *rows, int n_rows, int x, int y);
+
+
+/**
+ * @brief Turn off the set pixels of a bitmap. See fb_blit().
+*/
+void fb_erase(const u32 *rows, int n_rows, int x, int y);
+
+
+/**
+ * @brief Replace `width` pixels of row y, starting at x, with the bits of
+ *        `bits`. Bit `n` of `bits[n / 32]` is the pixel `n` steps to the right
+ *        of (x, y). Unlike fb_blit(), the pixels that are off in `bits` are
+ *        turned off, so whatever was there before is overwritten.
+*/
+void fb_write_span(const u32 *bits, int width, int x, int y);
+
+
+/**
+ * @brief Move a bitmap that has been drawn with fb_blit() from (x0, y0) to
+ *        (x1, y1). Only the pixels in the symmetric difference of the old and
+ *        new positions are touched.
+*/
+void fb_move(const u32 *rows, int n_rows, int x0, int y0, int x1, int y1);
+
+
+/**
+ * @brief Send every pixel that has changed since the last flush to the
+ *        display. Only the dirty rectangle is examined, and only the column
+ *        bytes of each page that differ from what the display is showing are
+ *        transmitted, in runs. See graphic_write_page().
+ *
+ *        The runs are sent from an interrupt by the render queue, so this
+ *        returns once they are recorded, unless the last flush hasn't been
+ *        sent yet. See render_queue.h.
+*/
+void fb_flush(void);
+
+
+#endif // __FRAMEBUFFER_H__
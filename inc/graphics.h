@@ -2,6 +2,7 @@
 #define __GRAPHICS_H__
 
 #include "typedef.h"
+#include "fixed.h"
 
 #define NameMaxSize 16
 #define PLAYER_1_ASCII_POS 1
@@ -13,8 +14,8 @@
 /// </summary>
 typedef struct
 {
-    i8 x;
-    i8 y;
+    int x;
+    int y;
 } Point, *P_Point;
 
 
@@ -29,7 +30,8 @@ typedef struct
 
 
 /// <summary>
-/// A rect, with an origin-point (top-left), and width + height.
+/// A rect, with an origin-point (top-left), and width + height. The opposite
+/// corner is at origin + dimen, so it covers dimen + 1 pixels in each direction.
 /// </summary>
 typedef struct
 {
@@ -38,29 +40,45 @@ typedef struct
 } Rect, *P_Rect;
 
 
+// The most vertices fill_poly() can handle. Any beyond it are ignored.
+#define POLY_MAX_VERTICES 32
+
+
 /**
- * @brief A polypoint is a polygon-shape with linked polygons.
+ * @brief A polygon, as a contiguous array of vertices. Consecutive vertices
+ *        are connected by edges, and the last one is connected back to the
+ *        first if the polygon is closed.
 */
-typedef struct poly_t
+typedef struct
 {
-    i8 x, y;
-    struct poly_t *next;
-} PolyPoint, *P_PolyPoint;
+    const Point *points;    // The vertices, in order.
+    int          count;     // The number of vertices in `points`.
+    bool         closed;    // Whether there is an edge from the last vertex
+                            // back to the first.
+} Polygon, *P_Polygon;
 
 
-// The maximum number of pixels a Geometry can hold.
-#define MAX_SIZE 32
-
 /**
- * @brief Models a geometric shape.
+ * @brief A 1bpp bitmap, stored as one mask per row. Bit `n` of a row is the
+ *        pixel `n` steps to the right of the sprite's origin, so a sprite can
+ *        be up to 32 pixels wide and any number of rows tall.
 */
 typedef struct
 {
-    int   num_points;
-    int   size_x;
-    int   size_y;
-    Point px[MAX_SIZE];
-} Geometry, *P_Geometry;
+    const u32 *rows;    // The pixel-data, top row first.
+    int        n_rows;  // The number of masks in `rows`.
+    int        width;   // The bounds of the set pixels. Set by sprite_init().
+    int        height;
+} Sprite, *P_Sprite;
+
+// Initialize a Sprite from an array of row masks.
+#define SPRITE(row_masks) { row_masks, sizeof(row_masks) / sizeof(u32), 0, 0 }
+
+
+/**
+ * @brief Compute the width and height of a sprite from its pixel-data.
+*/
+void sprite_init(P_Sprite sprite);
 
 
 /**
@@ -68,11 +86,11 @@ typedef struct
 */
 typedef struct Obj_t
 {
-    P_Geometry geo;    // The pixel-data of this object.
-    int        dir_x;  // The horizontal direction of this object.
-    int        dir_y;  // The vertical direction of this object.
-    int        pos_x;  // The x-position of this object.
-    int        pos_y;  // The y-position of this object.
+    P_Sprite   sprite; // The pixel-data of this object.
+    fixed      dir_x;  // The horizontal velocity, in pixels per tick.
+    fixed      dir_y;  // The vertical velocity, in pixels per tick.
+    fixed      pos_x;  // The x-position of this object. Rounded when drawn.
+    fixed      pos_y;  // The y-position of this object. Rounded when drawn.
 
     // Render this object.
     void (*draw)      (struct Obj_t*);
@@ -81,17 +99,17 @@ typedef struct Obj_t
     // Move this object.
     void (*move)      (struct Obj_t*);
     // Set the delta vector of this object.
-    void (*set_speed) (struct Obj_t*, int, int);
+    void (*set_speed) (struct Obj_t*, fixed, fixed);
+
+    // The position before the last tick. See draw_object_between().
+    fixed      prev_x;
+    fixed      prev_y;
+    // Where this object is in the framebuffer, in whole pixels.
+    int        drawn_x;
+    int        drawn_y;
 } Object, *P_Object;
 
 
-typedef struct
-{
-    bool is_colliding;
-    i8   which;         // Left = 'l', Right = 'r', Up = 'u' and Down = 'd'
-} WallCollision;
-
-
 typedef struct
 {
     char     name[NameMaxSize]; // Ascii info
@@ -110,7 +128,7 @@ void draw_object(P_Object obj);
 
 
 /**
- * @brief Clear an object's off the screen.
+ * @brief Clear an object's off the screen, where it was last drawn.
  * 
  * @param obj The object whose pixels to delete.
 */
@@ -118,22 +136,37 @@ void clear_object(P_Object obj);
 
 
 /**
- * @brief Get the absolute value of a byte.
+ * @brief Move an object on the screen to a point between where it was before
+ *        the last tick and where it is now. Only the pixels that differ from
+ *        what the display shows are sent, see fb_flush().
+ * 
+ * @param obj   The object to draw.
+ * @param alpha How far the object has come, from 0 at its previous position
+ *              to FX_ONE at its current one.
+*/
+void draw_object_between(P_Object obj, fixed alpha);
+
+
+/**
+ * @brief Get the absolute value of an integer.
 */
-i8 abs(i8 nr);
+int abs(int nr);
 
 
 /**
- * @brief Swap the values of two chars.
+ * @brief Swap the values of two integers.
 */
-void swap(i8 *a, i8 *b);
+void swap(int *a, int *b);
 
 
-// Functions for drawing graphics.
+// Functions for drawing graphics. Each returns 1 if anything was drawn inside
+// the bounds of the screen, 0 otherwise.
 
 int draw_line(P_Line      line);
 int draw_rect(P_Rect      rect);
-int draw_poly(P_PolyPoint poly);
+int fill_rect(P_Rect      rect);
+int draw_poly(P_Polygon   poly);
+int fill_poly(P_Polygon   poly);
 
 
 #endif // __GRAPHICS_H__
\ No newline at end of file
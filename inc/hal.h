@@ -0,0 +1,43 @@
+#ifndef __HAL_H__
+#define __HAL_H__
+
+#include "typedef.h"
+
+/*
+ * Hardware abstraction layer.
+ *
+ * Everything the game needs from the board goes through the functions declared
+ * here and in the headers included below. There are two implementations:
+ *
+ *   src/md407  The MD407 board (the default `make all` target).
+ *   src/host   A native build for a PC (`make host`), with emulated display
+ *              controllers, a scripted keypad and a virtual clock.
+ *
+ * Code in src/ must only talk to the hardware through this interface.
+ */
+
+#include "ks0108.h"         // Graphic display: ks0108_*
+#include "ascii.h"          // Text display:    ascii_*
+#include "keyb.h"           // Keypad:          activate_row, read_columns
+#include "clock.h"          // Time:            now, delay_until
+#include "delay.h"          // Delays:          delay_* (portable, built on clock.h)
+#include "timer.h"          // Interrupts:      timer_start, wait_for_interrupt
+#include "cycles.h"         // Cycle counter:   cycles_*
+#include "uart.h"           // Serial port:     uart_putc
+
+
+/**
+ * @brief Bring up clocks and I/O ports, and start the free-running clock. Must
+ *        be called before anything else.
+*/
+void app_init(void);
+
+
+/**
+ * @brief End the run, once a replay has finished. The host prints its report
+ *        and exits. The board has nowhere to return to, so it idles.
+*/
+void app_finish(void);
+
+
+#endif // __HAL_H__
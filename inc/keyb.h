@@ -18,8 +18,30 @@ typedef struct
 } Input;
 
 
+// The number of keys on the keypad.
+#define KEYB_KEYS 16
+
+// How many consecutive samples (one per millisecond) a key must be stable for
+// before a press or release is reported.
+#define KEYB_DEBOUNCE 5
+
+// The number of events that fit in the event queue.
+#define KEYB_QUEUE_SIZE 16
+
+
+/**
+ * @brief A debounced press or release of a key.
+*/
+typedef struct
+{
+    u32  time;      // ticker_millis() when the change was confirmed.
+    u8   key;       // The key value, see KEYCODE.
+    bool pressed;   // true for a press, false for a release.
+} KeyEvent;
+
+
 /**
- * @brief Activates a specific row.
+ * @brief Activates a specific row. Part of the hardware abstraction layer.
  * 
  * @param row The row on the keyboard to active.
 */
@@ -27,10 +49,11 @@ void activate_row(u32 row);
 
 
 /**
- * @brief Reads each column and returns the index of the key being pressed,
- *        if that.
+ * @brief Reads the columns of the active row. Bit 0 is set if a key in
+ *        column 1 is pressed, bit 3 if a key in column 4 is pressed. Part of
+ *        the hardware abstraction layer.
 */
-int read_column();
+u8 read_columns(void);
 
 /**
  * @brief Reads which columns have active buttons and stores them in a buffer.
@@ -54,6 +77,56 @@ u8 key_value(u32 row, u32 col);
 Input *keyb(void);
 
 
+/**
+ * @brief Scan all rows of the keypad.
+ *
+ * @return A bitmask of the keys being pressed, indexed by key value.
+*/
+u16 keyb_scan(void);
+
+
+/**
+ * @brief Start sampling the keypad in the background, from the ticker's
+ *        interrupt. The ticker must be running.
+*/
+void keyb_init(void);
+
+
+/**
+ * @brief Take one sample of the keypad and debounce it. Called from the
+ *        ticker's interrupt by keyb_init().
+*/
+void keyb_sample(void);
+
+
+/**
+ * @brief Return the debounced keys that are held, as a bitmask indexed by key
+ *        value.
+*/
+u16 keyb_held(void);
+
+
+/**
+ * @brief Take the oldest event out of the queue.
+ *
+ * @return true if an event was written to `event`, false if the queue is
+ *         empty.
+*/
+bool keyb_next_event(KeyEvent *event);
+
+
+/**
+ * @brief Discard all queued events.
+*/
+void keyb_clear_events(void);
+
+
+/**
+ * @brief Return the number of events lost because the queue was full.
+*/
+u32 keyb_dropped_events(void);
+
+
 /**
  * @brief A matrix with the key-values for the keypad.
  */
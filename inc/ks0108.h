@@ -0,0 +1,65 @@
+#ifndef __KS0108_H__
+#define __KS0108_H__
+
+#include "typedef.h"
+
+// The bus of the graphic display is part of the hardware abstraction layer
+// (see hal.h). The 128x64 panel is driven by two KS0108 controllers, one for
+// each half. A controller holds 8 pages of 64 column bytes. Bit `n` of a
+// column byte is the pixel `n` rows below the top of its page.
+//
+// Every backend implements the functions below. They wait for the selected
+// controllers to be ready before each transfer. The instructions are sent by
+// display_driver.c.
+
+
+// The controllers, as a mask. Writes may select both at once.
+#define KS0108_LEFT   0x01
+#define KS0108_RIGHT  0x02
+#define KS0108_BOTH   (KS0108_LEFT | KS0108_RIGHT)
+
+// The size of the display RAM of one controller.
+#define KS0108_PAGES    8
+#define KS0108_COLUMNS 64
+
+// Instructions. The low bits of the last three are an operand.
+#define KS0108_DISPLAY_OFF  0x3E
+#define KS0108_DISPLAY_ON   0x3F
+#define KS0108_SET_ADDRESS  0x40   // Column, 0-63.
+#define KS0108_SET_PAGE     0xB8   // Page, 0-7.
+#define KS0108_START_LINE   0xC0   // Row shown at the top, 0-63.
+
+// Set in the status register while an instruction is executing.
+#define KS0108_STATUS_BUSY  0x80
+
+
+/**
+ * @brief Reset the controllers and set up the port. The display is off and
+ *        the contents of its RAM are undefined until written.
+*/
+void ks0108_init(void);
+
+
+/**
+ * @brief Send an instruction to the selected controllers.
+*/
+void ks0108_command(u8 chips, u8 cmd);
+
+
+/**
+ * @brief Write a column byte at the current page and column of the selected
+ *        controllers. The column is incremented afterwards, wrapping from 63
+ *        to 0.
+*/
+void ks0108_write(u8 chips, u8 data);
+
+
+/**
+ * @brief Read the output register of one controller, then load it with the
+ *        column byte at the current address and increment the column. The
+ *        first read after setting the address is a dummy read.
+*/
+u8 ks0108_read(u8 chip);
+
+
+#endif // __KS0108_H__
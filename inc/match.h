@@ -0,0 +1,109 @@
+#ifndef __MATCH_H__
+#define __MATCH_H__
+
+#include "typedef.h"
+#include "fixed.h"
+#include "graphics.h"
+
+
+// The rate of the game logic. Drawing runs at its own rate, see
+// draw_object_between().
+#define TICK_HZ 60
+
+// Speeds in pixels per second, converted to fixed-point pixels per tick.
+#define PADDLE_SPEED (INT_TO_FX( 60) / TICK_HZ)
+#define BALL_SPEED   (INT_TO_FX(150) / TICK_HZ)
+
+// The points needed to win a match.
+#define MAX_SCORE 3
+
+
+/**
+* @brief The rules a match is played by.
+*/
+typedef enum
+{
+    MODE_CLASSIC,       // One ball. A point ends the round.
+    MODE_MULTIBALL      // Every paddle hit adds a ball. The round ends when
+                        // the last ball has left the field.
+} GameMode;
+
+
+/**
+ * @brief Everything about a match that can be tuned.
+*/
+typedef struct
+{
+    GameMode mode;
+    fixed    ball_speed;    // In fixed-point pixels per tick.
+    fixed    paddle_speed;  // In fixed-point pixels per tick.
+    u32      max_score;
+} MatchRules;
+
+// The rules the game is played by on the board.
+#define MATCH_RULES(mode) { (mode), BALL_SPEED, PADDLE_SPEED, MAX_SCORE }
+
+
+/**
+ * @brief Where a match stands after a frame.
+*/
+typedef enum
+{
+    MATCH_PLAYING,      // The round goes on.
+    MATCH_ROUND_OVER,   // The last ball has left the field.
+    MATCH_OVER          // A player has reached `max_score`.
+} MatchState;
+
+
+/**
+ * @brief A match between two players. The balls are the entities of the
+ *        entity store, so only one match can be played at a time per thread.
+ *
+ *        The paddles are moved with their move() function and nothing else is
+ *        drawn, so a match is as headless as its paddles are.
+*/
+typedef struct
+{
+    MatchRules rules;
+    P_Player   left;
+    P_Player   right;
+    u8         ball_sprite;     // Sprite id of the balls in the entity store.
+    u32        rally;           // Paddle hits since the round started.
+} Match, *P_Match;
+
+
+/**
+ * @brief Set up a match with both players on zero points. Call
+ *        match_new_round() before the first frame.
+*/
+void match_init(P_Match match, const MatchRules *rules, P_Player left, P_Player right, u8 ball_sprite);
+
+
+/**
+ * @brief Put a single ball in the middle of the field and both paddles in
+ *        their starting positions.
+*/
+void match_new_round(P_Match match);
+
+
+/**
+ * @brief Play one frame. The paddles are moved in the given directions, then
+ *        every ball is moved, and points are scored, for each of `steps`
+ *        logic ticks. Where everything was before the last tick is kept, so
+ *        it can be drawn in between until the next frame.
+ *
+ * @param left_dy  -1 to move the left paddle up, 1 to move it down or 0.
+ * @param right_dy The same for the right paddle.
+ *
+ * @return Whether the round or the match ended in this frame.
+*/
+MatchState match_frame(P_Match match, i8 left_dy, i8 right_dy, u32 steps);
+
+
+/**
+ * @brief Return the player that has won the match, or NULL if there is none.
+*/
+P_Player match_winner(P_Match match);
+
+
+#endif // __MATCH_H__
@@ -99,6 +99,10 @@ typedef volatile struct
 } systick_t;
 
 
+#define VTOR_PENDSV_IRQ  ((void(**)(void))(SCB_RELOC_ADDR + 0x38))
+#define VTOR_SYSTICK_IRQ ((void(**)(void))(SCB_RELOC_ADDR + 0x3C))
+
+
 /* SYSCFG */
 
 typedef volatile struct
@@ -179,6 +183,9 @@ typedef volatile struct
 /* CONTROL REGISTER BITS */
 
 #define B_E      0x40       /* Enable-signal          */
+#define B_RST    0x20       /* 0 = Reset graphic      */
+#define B_CS2    0x10       /* Right graphic half     */
+#define B_CS1    0x08       /* Left graphic half      */
 #define B_SELECT 0x04       /* Choose ASCII-display   */
 #define B_RW     0x02       /* 1 = Write, 0 = Read    */
 #define B_RS     0x01       /* 1 = Data,  0 = Control */
@@ -200,6 +207,8 @@ typedef volatile struct
 // ICSR - Interrupt Control and State Register
 #define SCB_ICSR ((volatile u32*)0xE000ED04)
 #define BIT_NMI_PEND_SET (1<<32)
+#define BIT_PENDSV_SET   (1<<28)
+#define BIT_PENDST_SET   (1<<26)
 
 // CFSR - Configurable Fault Status Register
 #define SCB_CFSR  ((volatile u32*)0xE000ED28)
@@ -289,6 +298,30 @@ typedef volatile struct
 #define VTOR_TIM6_IRQ ((void(**)(void))(SCB_RELOC_ADDR + 0x118))
 
 
+/* DWT - Data Watchpoint and Trace */
+
+#define DEMCR        ((volatile u32*)0xE000EDFC)
+#define DEMCR_TRCENA (1<<24)
+
+#define DWT_CTRL           ((volatile u32*)0xE0001000)
+#define DWT_CYCCNT         ((volatile u32*)0xE0001004)
+#define DWT_CTRL_CYCCNTENA (1<<0)
+
+
+/* USART1 - set up by md407_runtime_uartinit */
+
+#define USART1_SR ((volatile u16*)0x40011000)
+#define USART1_DR ((volatile u16*)0x40011004)
+#define USART1_CR1 ((volatile u16*)0x4001100C)
+#define USART_SR_TXE    0x80
+#define USART_CR1_TXEIE 0x80
+
+#define NVIC_USART1_IRQ_BPOS (1<<5)
+#define NVIC_USART1_ISER ((volatile u32*)0xE000E104)
+
+#define VTOR_USART1_IRQ ((void(**)(void))(SCB_RELOC_ADDR + 0xD4))
+
+
 /* SHCSR - System Handler Control and State Register */
 
 #define SHCSR 0xE000ED24
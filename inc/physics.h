@@ -0,0 +1,83 @@
+#ifndef __PHYSICS_H__
+#define __PHYSICS_H__
+
+#include "typedef.h"
+#include "graphics.h"
+#include "fixed.h"
+
+
+// The playing field, in screen coordinates.
+#define FIELD_LEFT     1
+#define FIELD_RIGHT  128
+#define FIELD_TOP      1
+#define FIELD_BOTTOM  64
+
+// Times within a tick are fractions of TOI_ONE. Kept small enough that a
+// distance across the field in fixed-point times TOI_ONE fits in 32 bits.
+#define TOI_ONE (1 << 12)
+
+// The number of zones a paddle is divided into for choosing the angle of a
+// bounce. See BOUNCE_TABLE in physics.c.
+#define BOUNCE_ZONES 8
+
+// The most collisions resolved within a single tick.
+#define MAX_BOUNCES 4
+
+
+/**
+ * @brief The state of a ball that ball_step() works on.
+*/
+typedef struct
+{
+    fixed pos_x;
+    fixed pos_y;
+    fixed dir_x;
+    fixed dir_y;
+} Body;
+
+
+/**
+ * @brief The outcome of moving the ball for one tick.
+*/
+typedef struct
+{
+    u8   paddle_hits;   // Number of times the ball bounced off a paddle.
+    u8   wall_hits;     // Number of times the ball bounced off the top/bottom.
+    char scored;        // 'l' or 'r' if the ball left through that side, or 0.
+} BallStep;
+
+
+/**
+* @brief Moves the ball one tick, resolving collisions with the paddles and
+*        walls at the exact time they happen within the tick. The ball can't
+*        pass through a paddle or a wall, no matter how fast it moves.
+*
+*        A ball hitting the front of a paddle leaves at an angle that depends
+*        on where it hit: straight back in the middle, up to 52.5 degrees at
+*        the ends.
+*
+*        Only the position and direction of the ball are updated. The caller
+*        is responsible for redrawing it.
+*
+* @param ball     The ball to move.
+* @param sprite   The sprite of the ball, which gives its size.
+* @param l_paddle The left paddle.
+* @param r_paddle The right paddle.
+* @param speed    The speed of the ball after a paddle bounce, in fixed-point
+*                 pixels per tick.
+*/
+BallStep ball_step(Body *ball, P_Sprite sprite, P_Object l_paddle, P_Object r_paddle, fixed speed);
+
+
+/**
+* @brief Move every entity of the store one tick with ball_step(), in a single
+*        pass over the arrays. Nothing is added or removed, so the caller can
+*        act on the outcomes afterwards. The position before the tick is kept
+*        in `prev_x` and `prev_y`.
+*
+* @param results Set to the outcome for each entity, indexed by id.
+*/
+void entities_step(P_Object l_paddle, P_Object r_paddle, fixed speed, BallStep *results);
+
+
+#endif // __PHYSICS_H__
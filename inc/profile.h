@@ -0,0 +1,66 @@
+#ifndef __PROFILE_H__
+#define __PROFILE_H__
+
+#include "typedef.h"
+
+
+/**
+ * @brief The stages of a frame that are timed separately.
+*/
+typedef enum
+{
+    PROF_INPUT,     // Reading the keypad.
+    PROF_PHYSICS,   // Simulation steps.
+    PROF_RENDER,    // Drawing the frame and the scores, and flushing it.
+    PROF_FRAME,     // The whole frame, from start to end.
+    PROF_STAGES
+} ProfStage;
+
+
+// Each power of two of cycles is split into this many histogram buckets, so
+// percentiles are accurate to within 1/PROF_SUB_BUCKETS of their value.
+#define PROF_SUB_BITS    3
+#define PROF_SUB_BUCKETS (1 << PROF_SUB_BITS)
+#define PROF_BUCKETS     (32 * PROF_SUB_BUCKETS)
+
+// How often the statistics should be reported and reset with profile_report(),
+// in milliseconds.
+#define PROF_REPORT_MS 1000
+
+
+/**
+ * @brief Start the cycle counter and clear all statistics.
+*/
+void profile_init(void);
+
+
+/**
+ * @brief Mark the start of a frame.
+*/
+void profile_frame_start(void);
+
+
+/**
+ * @brief Record the time since the last mark as a sample of `stage`, and set
+ *        a new mark. Call this at the end of each stage, in order.
+*/
+void profile_lap(ProfStage stage);
+
+
+/**
+ * @brief Record the time since profile_frame_start() as a sample of
+ *        PROF_FRAME.
+*/
+void profile_frame_end(void);
+
+
+/**
+ * @brief Send min/avg/max/p99 of every stage over the serial port, in cycles,
+ *        and reset the statistics. The report is a few hundred characters, so
+ *        it fits in the transmit buffer and is sent from the serial port's
+ *        interrupt without holding up the next frame. See uart_putc().
+*/
+void profile_report(void);
+
+
+#endif // __PROFILE_H__
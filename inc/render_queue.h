@@ -0,0 +1,77 @@
+#ifndef __RENDER_QUEUE_H__
+#define __RENDER_QUEUE_H__
+
+#include "typedef.h"
+
+
+// The most column bytes and runs a frame can hold. A whole screen is 1024
+// bytes. A frame that needs more is sent in several parts.
+#define RENDER_MAX_BYTES 1024
+#define RENDER_MAX_RUNS   256
+
+// The most column bytes sent by one run of the software interrupt. Each takes
+// about a microsecond, so the timer interrupt is never held up for long.
+#define RENDER_SLICE_BYTES 64
+
+
+/**
+ * @brief Counters kept by the render queue.
+*/
+typedef struct
+{
+    u32 frames;         // Frames handed to the interrupt by render_queue_submit().
+    u32 bytes;          // Column bytes sent to the display.
+    u32 stalls;         // Submits that had to wait for the frame before.
+    u32 max_pending;    // The most column bytes that have waited to be sent.
+} RenderStats;
+
+extern RenderStats render_stats;
+
+
+/**
+ * @brief Start sending frames from the software interrupt, see soft_irq_raise().
+ *        The interrupt sends RENDER_SLICE_BYTES at a time, and is raised again
+ *        by the ticker until the frame is out. The display must have been set
+ *        up with graphic_initialize(), and the ticker must be running.
+*/
+void render_queue_init(void);
+
+
+/**
+ * @brief Record a run of column bytes for the frame being put together, to be
+ *        written with graphic_write_page() once the frame has been submitted.
+ *        The bytes are copied. A frame that is full is submitted first.
+*/
+void render_queue_write_page(u8 page, u8 column, const u8 *bytes, u8 n);
+
+
+/**
+ * @brief Hand the frame that has been recorded to the interrupt, and start a
+ *        new one in the other buffer. Only one frame is sent at a time, so if
+ *        the frame before hasn't been sent yet, this waits for it.
+*/
+void render_queue_submit(void);
+
+
+/**
+ * @brief Return whether a frame is still being sent, so that submitting
+ *        another would wait.
+*/
+bool render_queue_busy(void);
+
+
+/**
+ * @brief Return the number of column bytes that have been submitted but not
+ *        sent yet.
+*/
+u32 render_queue_pending(void);
+
+
+/**
+ * @brief Wait until every submitted frame has been sent. Call this before
+ *        using the display driver directly.
+*/
+void render_queue_drain(void);
+
+
+#endif // __RENDER_QUEUE_H__
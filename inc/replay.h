@@ -0,0 +1,122 @@
+#ifndef __REPLAY_H__
+#define __REPLAY_H__
+
+#include "typedef.h"
+
+
+/*
+ * Recording and replay of the input of a match.
+ *
+ * The game only depends on the keys held and the number of logic ticks run in
+ * each frame, so that is all that is logged. Frames with the same input are
+ * run-length encoded into one line of text:
+ *
+ *   <frames> <steps> <keys> <hash>
+ *
+ * <frames> and <steps> are decimal, <keys> is the keypad bitmask and <hash> a
+ * checksum of the game state after every frame up to and including the last
+ * one of the line, both in hex. The key that started each match is logged
+ * on a line of its own:
+ *
+ *   s <key>
+ *
+ * Lines starting with `#` are ignored.
+ *
+ * When replaying, the game is driven from the log without waiting for the
+ * ticker, and the checksum of each line is compared with the replayed state.
+ */
+
+
+// The most frames one line of the log covers, so the state is checked at
+// least this often.
+#define REPLAY_MAX_RUN 255
+
+
+/**
+ * @brief The outcome of a replay.
+*/
+typedef struct
+{
+    u32 frames;          // Frames replayed.
+    u32 checks;          // Lines whose checksum has been compared.
+    u32 mismatches;      // Lines whose checksum differed.
+    u32 first_mismatch;  // The frame after which the first mismatch was found.
+    u32 hash;            // The checksum of all frames so far.
+} ReplayStats;
+
+extern ReplayStats replay_stats;
+
+
+/**
+ * @brief Record the input of every frame, and send the log a line at a time
+ *        to `put`. It is called while a frame runs, so it should queue the
+ *        line rather than wait for it to be sent, like uart_puts().
+*/
+void replay_record_to(void (*put)(const char *line));
+
+
+/**
+ * @brief Replay the log in `text` instead of reading the keypad. The text
+ *        must stay valid for the whole replay.
+*/
+void replay_load(const char *text);
+
+
+/**
+ * @brief Return whether the game is being driven from a log.
+*/
+bool replay_active(void);
+
+
+/**
+ * @brief Take the key that starts the next match from the log. A log without
+ *        start lines leaves `key` as it is.
+ *
+ * @return false once the log has run out.
+*/
+bool replay_start(u8 *key);
+
+
+/**
+ * @brief Take the input of the next frame from the log.
+ *
+ * @return false once the log has run out, or the match has ended in the log.
+*/
+bool replay_next(u32 *steps, u16 *keys);
+
+
+/**
+ * @brief Log the key that started a match, if recording.
+*/
+void replay_record_start(u8 key);
+
+
+/**
+ * @brief Log the input of a frame, if recording.
+*/
+void replay_record(u32 steps, u16 keys);
+
+
+/**
+ * @brief Add the state at the end of a frame to the checksum, and compare it
+ *        with the log at the end of each line when replaying.
+*/
+void replay_end_frame(u32 state_hash);
+
+
+/**
+ * @brief Send the line that is being built, if recording. Call this when the
+ *        match ends.
+*/
+void replay_flush(void);
+
+
+/**
+ * @brief Mix a word into a checksum. Start with REPLAY_HASH_INIT.
+*/
+u32 replay_hash(u32 hash, u32 word);
+
+#define REPLAY_HASH_INIT 0x811C9DC5
+
+
+#endif // __REPLAY_H__
@@ -0,0 +1,119 @@
+#ifndef __SCHED_H__
+#define __SCHED_H__
+
+#include "typedef.h"
+
+
+// The most tasks that can be added with sched_add().
+#define SCHED_MAX_TASKS 8
+
+// The number of slots of the timer wheel, one millisecond each. Must be a
+// power of two. Timers further away than this go around the wheel until they
+// are due.
+#define SCHED_WHEEL_SLOTS 64
+
+
+/**
+ * @brief A task of the scheduler. Tasks run to completion, in the order they
+ *        were added, so an earlier task always goes first when several have
+ *        work. Use TASK() to set one up.
+*/
+typedef struct
+{
+    const char *name;
+    void      (*run)(void);
+    bool      (*ready)(void);   // Whether there is work for the task. NULL if
+                                // it runs every `period_ms` instead.
+    u32         period_ms;
+
+    // Kept by the scheduler.
+    bool               enabled;
+    u32                due_ms;
+    u32                runs;        // Since the last sched_report().
+    u32                max_cycles;  // The longest run, in cycles_now() counts.
+    unsigned long long sum_cycles;
+} Task, *P_Task;
+
+// Initialize a task. It is disabled until sched_enable() is called.
+#define TASK(name, run, ready, period_ms) \
+    { (name), (run), (ready), (period_ms), false, 0, 0, 0, 0 }
+
+
+/**
+ * @brief A one-shot timer. Its function is called from the scheduler, not an
+ *        interrupt, so it may do anything a task may.
+*/
+typedef struct SoftTimer_t
+{
+    void              (*fire)(void);
+    u32                 expires_ms;
+    struct SoftTimer_t *next;       // In the same slot of the wheel.
+    bool                armed;
+} SoftTimer, *P_SoftTimer;
+
+
+/**
+ * @brief Start the timer wheel at the current millisecond. The ticker must be
+ *        running.
+*/
+void sched_init(void);
+
+
+/**
+ * @brief Add a task, disabled.
+ *
+ * @return 1 if the task was added, 0 if there is no room for it.
+*/
+int sched_add(P_Task task);
+
+
+/**
+ * @brief Enable or disable a task. A periodic task that is enabled runs at
+ *        once, then every `period_ms`.
+*/
+void sched_enable(P_Task task, bool enabled);
+
+
+/**
+ * @brief Call a function once, `delay_ms` milliseconds from now. A timer that
+ *        is already running is started over.
+*/
+void sched_timer_start(P_SoftTimer timer, u32 delay_ms, void (*fire)(void));
+
+
+/**
+ * @brief Stop a timer before it fires. Does nothing if it isn't running.
+*/
+void sched_timer_cancel(P_SoftTimer timer);
+
+
+/**
+ * @brief Fire the timers that are due, then run the first task that has work.
+ *
+ * @return Whether anything ran.
+*/
+bool sched_run_once(void);
+
+
+/**
+ * @brief Run tasks and timers for ever, sleeping until the next interrupt
+ *        whenever there is nothing to do.
+*/
+void sched_run(void);
+
+
+/**
+ * @brief Send the CPU load since the last report over the serial port, as the
+ *        cycles spent busy and asleep in wait_for_interrupt(), followed by the
+ *        number of runs and the average and longest run time of every task,
+ *        in cycles. The task statistics are reset.
+ *
+ *        Each task adds a line of about 40 characters, and the whole report
+ *        comes to about 250. Even with the profile_report() sent in the same
+ *        pass, that is well within UART_TX_SIZE, so it is queued at once and
+ *        doesn't delay the tasks that run after it.
+*/
+void sched_report(void);
+
+
+#endif // __SCHED_H__
@@ -0,0 +1,90 @@
+#ifndef __TICKER_H__
+#define __TICKER_H__
+
+#include "typedef.h"
+#include "fixed.h"
+
+
+// The rate of the timer interrupt that drives the ticker.
+#define TICKER_BASE_HZ 1000
+
+// The most handlers that can be attached with ticker_attach().
+#define TICKER_MAX_HANDLERS 4
+
+// The most logic ticks ticker_wait() will hand out at once. Ticks beyond this
+// are dropped, so a stalled frame can't make the game fast-forward.
+#define TICKER_MAX_STEPS 4
+
+
+/**
+ * @brief Counters kept by the ticker, for detecting frames that took longer
+ *        than one tick.
+*/
+typedef struct
+{
+    u32 ticks;    // Logic ticks handed out by ticker_wait().
+    u32 frames;   // Calls to ticker_wait().
+    u32 overruns; // Frames that had more than one tick to catch up on.
+    u32 dropped;  // Ticks discarded because of TICKER_MAX_STEPS.
+} TickerStats;
+
+extern TickerStats ticker_stats;
+
+
+/**
+ * @brief Start the ticker.
+ *
+ * @param hz The logic tick rate, in [1, TICKER_BASE_HZ] Hz.
+*/
+void ticker_init(u32 hz);
+
+
+/**
+ * @brief Run a function from the timer interrupt, at TICKER_BASE_HZ. Used for
+ *        background work such as sampling the keypad. The handler must be
+ *        short and must not block.
+ *
+ * @return 1 if the handler was attached, 0 if there is no room for it.
+*/
+int ticker_attach(void (*handler)(void));
+
+
+/**
+ * @brief Block until the next logic tick.
+ *
+ * @return The number of logic ticks that have passed since the last call, in
+ *         [1, TICKER_MAX_STEPS]. The caller should run one simulation step
+ *         per tick.
+*/
+u32 ticker_wait(void);
+
+
+/**
+ * @brief Return whether a logic tick has passed since the last call to
+ *        ticker_wait(), so that ticker_wait() won't block.
+*/
+bool ticker_pending(void);
+
+
+/**
+ * @brief Return how far the ticker has come towards the next logic tick, from
+ *        0 up to but not including FX_ONE. Used to draw between ticks.
+*/
+fixed ticker_phase(void);
+
+
+/**
+ * @brief Discard the ticks that have passed since the last call to
+ *        ticker_wait(). Call this after a blocking pause so the game doesn't
+ *        try to catch up on it.
+*/
+void ticker_sync(void);
+
+
+/**
+ * @brief Return the number of milliseconds since ticker_init().
+*/
+u32 ticker_millis(void);
+
+
+#endif // __TICKER_H__
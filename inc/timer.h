@@ -0,0 +1,55 @@
+#ifndef __TIMER_H__
+#define __TIMER_H__
+
+#include "typedef.h"
+
+
+/**
+ * @brief Start a periodic timer interrupt. Part of the hardware abstraction
+ *        layer.
+ *
+ * @param hz      The interrupt rate, in [16, 1000000] Hz.
+ * @param handler Called from the interrupt, once per period.
+*/
+void timer_start(u32 hz, void (*handler)(void));
+
+
+/**
+ * @brief Install the handler of a software interrupt with a lower priority
+ *        than every other interrupt, for background work that takes too long
+ *        for the timer interrupt. Part of the hardware abstraction layer.
+*/
+void soft_irq_attach(void (*handler)(void));
+
+
+/**
+ * @brief Request the software interrupt. It runs once no other interrupt is
+ *        being serviced, so at once when requested by the game. Requests made
+ *        while it is pending are merged into one. Part of the hardware
+ *        abstraction layer.
+*/
+void soft_irq_raise(void);
+
+
+/**
+ * @brief Sleep until the next interrupt, and return once it has been
+ *        serviced. Returns right away if the backend can't wait. Part of the
+ *        hardware abstraction layer.
+ *
+ *        The caller polls its own condition around this. An interrupt that
+ *        changes the condition just before the call isn't missed for long, as
+ *        the timer interrupt wakes the CPU again within a period.
+*/
+void wait_for_interrupt(void);
+
+
+/**
+ * @brief Return the cycles_now() counts spent awake since start-up, that is
+ *        everywhere but asleep in wait_for_interrupt(). Interrupts count as
+ *        awake, including the one that ends a sleep. It wraps around like
+ *        cycles_now(). Part of the hardware abstraction layer.
+*/
+u32 busy_cycles(void);
+
+
+#endif // __TIMER_H__
@@ -20,6 +20,15 @@ typedef enum
 } bool;
 
 
+// Marks state of the game logic that each thread of the host tournament
+// needs its own copy of, see bench/tournament.c. The board has one thread.
+#ifdef PONG_THREADS
+#define THREAD_LOCAL _Thread_local
+#else
+#define THREAD_LOCAL
+#endif
+
+
 #ifndef NULL
 #define NULL 0
 #endif
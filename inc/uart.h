@@ -0,0 +1,39 @@
+#ifndef __UART_H__
+#define __UART_H__
+
+#include "typedef.h"
+
+
+// The number of characters that can wait to be sent. Must be a power of two.
+// A second of reports and recorded input fits with room to spare.
+#define UART_TX_SIZE 1024
+
+
+/**
+ * @brief Start sending from the transmit buffer. Called by app_init(). Part of
+ *        the hardware abstraction layer.
+*/
+void uart_init(void);
+
+
+/**
+ * @brief Queue a character for the serial port. It is sent from the serial
+ *        port's interrupt, so this returns at once, unless the buffer is full.
+ *        Part of the hardware abstraction layer.
+*/
+void uart_putc(char c);
+
+
+/**
+ * @brief Send a string over the serial port.
+*/
+void uart_puts(const char *s);
+
+
+/**
+ * @brief Send an unsigned number in decimal over the serial port.
+*/
+void uart_put_u32(u32 n);
+
+
+#endif // __UART_H__
@@ -0,0 +1,105 @@
+#include "ascii_buffer.h"
+
+// =============================================================================
+//                         INCLUDES & PRE-PROCESSOR
+
+#include "ascii_queue.h"
+#include "typedef.h"
+
+
+// =============================================================================
+//                                GLOBAL DATA
+
+// What the game wants on the display, and what the display is showing.
+static u8 wanted[ASCII_ROWS][ASCII_COLUMNS];
+static u8 shown [ASCII_ROWS][ASCII_COLUMNS];
+
+// One bit per cell that has been written since the last flush.
+static u32 dirty[ASCII_ROWS];
+
+static u32 cursor_x    = 0;
+static u32 cursor_line = 0;
+
+
+// =============================================================================
+//                                 FUNCTIONS
+
+void ascii_buf_init(void)
+{
+    for (u32 line = 0; line < ASCII_ROWS; line++)
+    {
+        for (u32 x = 0; x < ASCII_COLUMNS; x++)
+        {
+            wanted[line][x] = ' ';
+            shown [line][x] = ' ';
+        }
+        dirty[line] = 0;
+    }
+
+    cursor_x    = 0;
+    cursor_line = 0;
+}
+
+
+void ascii_buf_clear(void)
+{
+    for (u32 line = 0; line < ASCII_ROWS; line++)
+    {
+        for (u32 x = 0; x < ASCII_COLUMNS; x++)
+            wanted[line][x] = ' ';
+        dirty[line] = (1u << ASCII_COLUMNS) - 1;
+    }
+}
+
+
+void ascii_buf_goto(u32 x, u32 line)
+{
+    cursor_x    = x - 1;
+    cursor_line = line - 1;
+}
+
+
+void ascii_buf_putc(u8 c)
+{
+    if (cursor_x >= ASCII_COLUMNS || cursor_line >= ASCII_ROWS)
+        return;
+
+    wanted[cursor_line][cursor_x] = c;
+    dirty [cursor_line] |= 1u << cursor_x;
+    cursor_x++;
+}
+
+
+void ascii_buf_puts(const char *s)
+{
+    while (*s)
+        ascii_buf_putc(*s++);
+}
+
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+void ascii_buf_flush(void)
+{
+    for (u32 line = 0; line < ASCII_ROWS; line++)
+    {
+        // Where the controller's address counter points, as a column on this
+        // line. Consecutive changed cells are written without a goto.
+        u32 address = ASCII_COLUMNS;
+
+        for (u32 x = 0; dirty[line] >> x; x++)
+        {
+            if (!((dirty[line] >> x) & 1) || wanted[line][x] == shown[line][x])
+                continue;
+
+            if (address != x)
+                ascii_goto(x + 1, line + 1);
+
+            ascii_write_char(wanted[line][x]);
+            shown[line][x] = wanted[line][x];
+            address = x + 1;
+        }
+
+        dirty[line] = 0;
+    }
+}
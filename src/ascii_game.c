@@ -1,12 +1,11 @@
 // =============================================================================
 //                         INCLUDES & PRE-PROCESSOR
 
-#include "ascii.h"
+#include "ascii_buffer.h"
 #include "ascii_game.h"
 #include "graphics.h"
-#include "display_driver.h"
-#include "delay.h"
-#include "memreg.h"
+#include "framebuffer.h"
+#include "font.h"
 #include "typedef.h"
 
 
@@ -14,82 +13,72 @@
 //									STRUCTS
 
 /**
- * @brief Assuming ascii_display has been initiated
+ * @brief Assuming ascii_display has been initiated. All text is written to the
+ *        shadow buffer and sent by the next ascii_buf_flush().
+ *
+ *        The scores are drawn on the graphic display, see font.h.
 */
-void ascii_draw_score(P_Player p)
-{
-	
-	ascii_goto(p->display_position + 7 , 2);
-	ascii_write_char(p->points + 48);
-}
-
-
 void ascii_draw_name(P_Player p)
 {	
-	const char *s;
-	ascii_goto((p->display_position), 1);
-	s = p->name; // Fixed: Direct assignment without & operator
-	
-	// Print out each character.
-	while (*s)
-		ascii_write_char(*s++);
+	ascii_buf_goto((p->display_position), 1);
+	ascii_buf_puts(p->name);
 }
 
 
 void ascii_init_game (P_Player p1, P_Player p2)
 {
-	char *s;
+	ascii_buf_clear();
 	ascii_draw_name(p1);
 	ascii_draw_name(p2);
+	ascii_buf_flush();
+}
 
-	const char score[] = "Score: ";	
-	ascii_goto((p1 -> display_position), 2);	
-	
-	s = score;
-	while (*s)
-		ascii_write_char(*s++);
-	
-	ascii_goto((p2 -> display_position), 2);	
-	
-	s = score;
-	while (*s)
-		ascii_write_char(*s++);
+
+/**
+ * @brief Draw a line of text in the middle of the graphic display.
+*/
+static void graphic_text_centred(const char *text, int y)
+{
+	font_draw(&font_small, text, (FB_WIDTH - font_text_width(&font_small, text)) / 2 + 1, y);
 }
 
 
 void ascii_player_wins(P_Player p)
 {
-	graphic_clear_screen();
-	//ascii_command(0b00000001, delay_milli,  2);
-	char wins[] = "wins!";
-	char* s;
-	ascii_goto(1,1);
-	s = (p -> name);
-	while (*s)
-		ascii_write_char(*s++);
-	s = wins;
-	while (*s)
-		ascii_write_char(*s++);
+	fb_clear();
+	ascii_buf_goto(1,1);
+	ascii_buf_puts(p -> name);
+	ascii_buf_puts("wins!");
+	ascii_buf_flush();
+
+	// The same line on the graphic display. The name ends in a space.
+	char line[NameMaxSize + sizeof "wins!"];
+	int  n = 0;
+
+	for (const char *c = p -> name; *c && n < NameMaxSize; c++)
+		line[n++] = *c;
+	for (const char *c = "wins!"; *c; c++)
+		line[n++] = *c;
+	line[n] = '\0';
+
+	graphic_text_centred(line, 30);
+	fb_flush();
 }
 
 
 void ascii_start_screen(void)
 {
-	ascii_command(0b00000001, delay_milli,  2);
+	ascii_buf_clear();
 
-	char welcome[] = "Welcome to Superpong!";
-	char press[]   = "Press 5 to start.";
+	ascii_buf_goto(1, 1);
+	ascii_buf_puts("Welcome to Superpong!");
 
-	ascii_goto(1, 1);
-	
-	char *s = welcome;
-	while (*s)
-		ascii_write_char(*s++);
+	ascii_buf_goto(1,2);
+	ascii_buf_puts("4:CPU 5:2P 6:Multi");
 
-	ascii_goto(1,2);
+	ascii_buf_flush();
 
-	s = press;
-	
-	while (*s)
-		ascii_write_char(*s++);
-}
\ No newline at end of file
+	graphic_text_centred("SUPERPONG", 24);
+	graphic_text_centred("4:CPU 5:2P 6:MULTI", 36);
+	fb_flush();
+}
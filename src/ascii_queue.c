@@ -0,0 +1,113 @@
+#include "ascii_queue.h"
+
+// =============================================================================
+//                         INCLUDES & PRE-PROCESSOR
+
+#include "ascii.h"
+#include "clock.h"
+#include "ticker.h"
+#include "timer.h"
+#include "typedef.h"
+
+
+// Set in a queue entry that holds a character rather than an instruction.
+#define ENTRY_DATA 0x100
+
+
+// =============================================================================
+//                                GLOBAL DATA
+
+// `head` is only written by the game and `tail` only by the interrupt, so no
+// locking is needed.
+static u16          queue[ASCII_QUEUE_SIZE];
+static volatile u32 head = 0;
+static volatile u32 tail = 0;
+
+// now() when the instruction that was sent last has finished executing.
+static u32 ready_at = 0;
+
+
+// =============================================================================
+//                                 FUNCTIONS
+
+void ascii_queue_init(void)
+{
+    ready_at = now();
+    ticker_attach(ascii_queue_pump);
+}
+
+
+/**
+ * @brief Add an entry to the queue. If it is full, wait for the interrupt to
+ *        make room rather than lose text.
+ */
+static void push(u16 entry)
+{
+    u32 next = (head + 1) & (ASCII_QUEUE_SIZE - 1);
+
+    while (next == tail)
+        wait_for_interrupt();
+
+    queue[head] = entry;
+
+    // The entry must be in the queue before the interrupt can see it. `queue`
+    // isn't volatile, so without this the compiler may store it after `head`.
+    __asm__ volatile ("" ::: "memory");
+    head = next;
+}
+
+
+void ascii_goto(u32 row, u32 column)
+{
+    u32 address = row - 1;
+
+    if (column == 2)
+        address += 0x40;
+
+    push(0x80 | address);
+}
+
+
+void ascii_write_char(u8 c)
+{
+    push(ENTRY_DATA | c);
+}
+
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+/**
+ * @brief The controller can't take anything until the last instruction has had
+ *        its execution time, and until it has cleared its busy flag. The flag
+ *        is only read once the time has passed, so the common case costs a
+ *        single read of the clock.
+ */
+void ascii_queue_pump(void)
+{
+    if (tail == head)
+        return;
+
+    if ((i32)(now() - ready_at) < 0 || ascii_busy())
+        return;
+
+    u16 entry = queue[tail];
+    u32 exec  = ASCII_EXEC_US;
+
+    if (entry & ENTRY_DATA)
+        ascii_write_data(entry & 0xFF);
+    else
+    {
+        ascii_write_cmd(entry);
+        if (entry < 0x04)
+            exec = ASCII_EXEC_SLOW_US;
+    }
+
+    ready_at = now() + exec * clock_ticks_per_us();
+    tail = (tail + 1) & (ASCII_QUEUE_SIZE - 1);
+}
+
+
+u32 ascii_queue_pending(void)
+{
+    return (head - tail) & (ASCII_QUEUE_SIZE - 1);
+}
@@ -0,0 +1,144 @@
+#include "cpu_paddle.h"
+
+// =============================================================================
+//                         INCLUDES & PRE-PROCESSOR
+
+#include "entity.h"
+#include "fixed.h"
+#include "graphics.h"
+#include "physics.h"
+#include "typedef.h"
+
+
+// How far the paddle may be from its target before it moves. Keeps it from
+// jittering around the target.
+#define DEAD_ZONE INT_TO_FX(1)
+
+#define FX_TOP     INT_TO_FX(FIELD_TOP)
+#define FX_BOTTOM  INT_TO_FX(FIELD_BOTTOM)
+#define FX_MIDDLE  ((FX_TOP + FX_BOTTOM) / 2)
+
+
+// =============================================================================
+//                                 FUNCTIONS
+
+void cpu_paddle_init(
+    P_CpuPaddle cpu,
+    P_Object    paddle,
+    u8          reaction_frames,
+    u8          error_px,
+    u32         seed
+)
+{
+    cpu->paddle          = paddle;
+    cpu->reaction_frames = reaction_frames;
+    cpu->error_px        = error_px;
+
+    cpu->seen_dir_x  = 0;
+    cpu->seen_dir_y  = 0;
+    cpu->seen_count  = -1;
+    cpu->next_target = FX_MIDDLE;
+    cpu->target      = FX_MIDDLE;
+    cpu->delay       = 0;
+    cpu->seed        = seed;
+}
+
+
+/**
+ * @brief The ball moves in a straight line until it reaches the paddle, except
+ *        that the walls fold its path back into the field. Unfolded, the top
+ *        of the ball travels `distance * dir_y / dir_x`, and folding that into
+ *        the range it can occupy gives where it really is.
+ */
+fixed cpu_paddle_predict(P_Object paddle)
+{
+    if (entities.count == 0)
+        return FX_MIDDLE;
+
+    P_Sprite sprite = entity_sprite(entities.sprite[0]);
+    fixed    w      = INT_TO_FX(sprite->width);
+    fixed    h      = INT_TO_FX(sprite->height);
+
+    fixed x     = entities.pos_x[0];
+    fixed y     = entities.pos_y[0];
+    fixed dir_x = entities.dir_x[0];
+    fixed dir_y = entities.dir_y[0];
+
+    // The distance between the facing sides of the ball and the paddle.
+    fixed distance;
+
+    if (paddle->pos_x > x)
+    {
+        if (dir_x <= 0)
+            return FX_MIDDLE;
+        distance = paddle->pos_x - (x + w);
+    }
+    else
+    {
+        if (dir_x >= 0)
+            return FX_MIDDLE;
+        distance = x - (paddle->pos_x + INT_TO_FX(paddle->sprite->width));
+    }
+
+    if (distance < 0)
+        distance = 0;
+
+    // The top of the ball stays within [FX_TOP, FX_TOP + span].
+    fixed span   = FX_BOTTOM - h - FX_TOP;
+    fixed period = 2 * span;
+    fixed offset = y - FX_TOP + distance * dir_y / abs(dir_x);
+
+    offset %= period;
+    if (offset < 0)
+        offset += period;
+    if (offset > span)
+        offset = period - offset;
+
+    return FX_TOP + offset + h / 2;
+}
+
+
+/**
+ * @brief A small linear congruential generator, so the aiming error is the
+ *        same on every run with the same seed.
+ */
+static u32 next_random(P_CpuPaddle cpu)
+{
+    cpu->seed = cpu->seed * 1664525 + 1013904223;
+    return cpu->seed >> 16;
+}
+
+
+i8 cpu_paddle_update(P_CpuPaddle cpu)
+{
+    fixed dir_x = entities.count ? entities.dir_x[0] : 0;
+    fixed dir_y = entities.count ? entities.dir_y[0] : 0;
+
+    // Predict again only if the ball has changed course.
+    if (dir_x != cpu->seen_dir_x || dir_y != cpu->seen_dir_y
+        || entities.count != cpu->seen_count)
+    {
+        cpu->seen_dir_x = dir_x;
+        cpu->seen_dir_y = dir_y;
+        cpu->seen_count = entities.count;
+
+        int error = 0;
+        if (cpu->error_px > 0)
+            error = (int)(next_random(cpu) % (2 * cpu->error_px + 1)) - cpu->error_px;
+
+        cpu->next_target = cpu_paddle_predict(cpu->paddle) + INT_TO_FX(error);
+        cpu->delay       = cpu->reaction_frames;
+    }
+
+    if (cpu->delay > 0)
+        cpu->delay--;
+    else
+        cpu->target = cpu->next_target;
+
+    fixed centre = cpu->paddle->pos_y + INT_TO_FX(cpu->paddle->sprite->height) / 2;
+    fixed diff   = cpu->target - centre;
+
+    if (diff >  DEAD_ZONE) return  1;
+    if (diff < -DEAD_ZONE) return -1;
+    return 0;
+}
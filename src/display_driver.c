@@ -1,32 +1,147 @@
 #include "display_driver.h"
 
-__attribute__((naked))
+// =============================================================================
+//                         INCLUDES & PRE-PROCESSOR
+
+#include "ks0108.h"
+#include "typedef.h"
+
+
+// Marks a page or column of a controller as unknown.
+#define UNKNOWN 0xFF
+
+
+// =============================================================================
+//                                GLOBAL DATA
+
+// Where each controller's address points, so it is only sent when it has to
+// change. Index 0 is the left controller.
+static u8 cur_page[2]   = { UNKNOWN, UNKNOWN };
+static u8 cur_column[2] = { UNKNOWN, UNKNOWN };
+
+
+// =============================================================================
+//                                 FUNCTIONS
+
+/**
+ * @brief Point one controller at a column of a page.
+ */
+static void set_address(int chip, u8 page, u8 column)
+{
+    u8 mask = chip ? KS0108_RIGHT : KS0108_LEFT;
+
+    if (cur_page[chip] != page)
+    {
+        ks0108_command(mask, KS0108_SET_PAGE | page);
+        cur_page[chip] = page;
+    }
+
+    if (cur_column[chip] != column)
+    {
+        ks0108_command(mask, KS0108_SET_ADDRESS | column);
+        cur_column[chip] = column;
+    }
+}
+
+
 void graphic_initialize(void)
 {
-    __asm__ volatile (" .HWORD 0xDFF0\n");
-    __asm__ volatile (" BX LR\n");
+    ks0108_init();
+    ks0108_command(KS0108_BOTH, KS0108_DISPLAY_ON);
+    ks0108_command(KS0108_BOTH, KS0108_START_LINE | 0);
+
+    graphic_clear_screen();
 }
 
 
-__attribute__((naked))
+/**
+ * @brief Both controllers are selected at once, so each byte clears two.
+ */
 void graphic_clear_screen(void)
 {
-    __asm__ volatile (" .HWORD 0xDFF1\n");
-    __asm__ volatile (" BX LR\n");
+    for (u8 page = 0; page < KS0108_PAGES; page++)
+    {
+        ks0108_command(KS0108_BOTH, KS0108_SET_PAGE | page);
+        ks0108_command(KS0108_BOTH, KS0108_SET_ADDRESS | 0);
+
+        for (int column = 0; column < KS0108_COLUMNS; column++)
+            ks0108_write(KS0108_BOTH, 0);
+    }
+
+    // The column has wrapped around to 0 on the last page.
+    for (int chip = 0; chip < 2; chip++)
+    {
+        cur_page[chip]   = KS0108_PAGES - 1;
+        cur_column[chip] = 0;
+    }
+}
+
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+/**
+ * @brief Read the byte the pixel is in and write it back with the pixel
+ *        changed. Reading moves the column on, so it is set twice.
+ */
+static void update_pixel(int x, int y, bool set)
+{
+    x--;
+    y--;
+
+    if ((unsigned)x >= 2 * KS0108_COLUMNS || (unsigned)y >= 8 * KS0108_PAGES)
+        return;
+
+    int chip   = x / KS0108_COLUMNS;
+    u8  mask   = chip ? KS0108_RIGHT : KS0108_LEFT;
+    u8  column = x % KS0108_COLUMNS;
+    u8  bit    = 1 << (y & 7);
+
+    set_address(chip, y >> 3, column);
+    ks0108_read(mask);
+    u8 byte = ks0108_read(mask);
+
+    ks0108_command(mask, KS0108_SET_ADDRESS | column);
+    ks0108_write(mask, set ? byte | bit : byte & ~bit);
+
+    cur_column[chip] = (column + 1) % KS0108_COLUMNS;
 }
 
 
-__attribute__((naked))
 void graphic_pixel_set(int x, int y)
 {
-    __asm__ volatile (" .HWORD 0xDFF2\n");
-    __asm__ volatile (" BX LR\n");
+    update_pixel(x, y, true);
 }
 
 
-__attribute__((naked))
 void graphic_pixel_clear(int x, int y)
 {
-    __asm__ volatile (" .HWORD 0xDFF3\n");
-    __asm__ volatile (" BX LR\n");
-}
\ No newline at end of file
+    update_pixel(x, y, false);
+}
+
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+void graphic_write_page(u8 page, u8 column, const u8 *bytes, u8 n)
+{
+    while (n > 0 && column < 2 * KS0108_COLUMNS)
+    {
+        int chip  = column / KS0108_COLUMNS;
+        u8  mask  = chip ? KS0108_RIGHT : KS0108_LEFT;
+        u8  start = column % KS0108_COLUMNS;
+
+        // The run may continue on the other controller.
+        u8 count = KS0108_COLUMNS - start;
+        if (count > n)
+            count = n;
+
+        set_address(chip, page, start);
+        for (u8 i = 0; i < count; i++)
+            ks0108_write(mask, bytes[i]);
+
+        cur_column[chip] = (start + count) % KS0108_COLUMNS;
+
+        column += count;
+        bytes  += count;
+        n      -= count;
+    }
+}
@@ -0,0 +1,106 @@
+#include "entity.h"
+
+// =============================================================================
+//                         INCLUDES & PRE-PROCESSOR
+
+#include "framebuffer.h"
+#include "graphics.h"
+#include "typedef.h"
+
+
+// =============================================================================
+//                                GLOBAL DATA
+
+THREAD_LOCAL EntityStore entities;
+
+static THREAD_LOCAL P_Sprite sprites[ENTITY_SPRITES];
+static THREAD_LOCAL int      n_sprites = 0;
+
+
+// =============================================================================
+//                                 FUNCTIONS
+
+int entity_add_sprite(P_Sprite sprite)
+{
+    if (n_sprites == ENTITY_SPRITES)
+        return -1;
+
+    sprites[n_sprites] = sprite;
+    return n_sprites++;
+}
+
+
+P_Sprite entity_sprite(u8 id)
+{
+    return sprites[id];
+}
+
+
+void entity_clear(void)
+{
+    entities.count = 0;
+}
+
+
+int entity_spawn(u8 sprite, fixed x, fixed y, fixed dx, fixed dy)
+{
+    if (entities.count == ENTITY_MAX)
+        return -1;
+
+    int i = entities.count++;
+
+    entities.pos_x[i]   = x;
+    entities.pos_y[i]   = y;
+    entities.dir_x[i]   = dx;
+    entities.dir_y[i]   = dy;
+    entities.prev_x[i]  = x;
+    entities.prev_y[i]  = y;
+    entities.sprite[i]  = sprite;
+    entities.drawn_x[i] = FX_TO_INT(x);
+    entities.drawn_y[i] = FX_TO_INT(y);
+
+    return i;
+}
+
+
+void entity_remove(int id)
+{
+    int last = --entities.count;
+
+    entities.pos_x[id]   = entities.pos_x[last];
+    entities.pos_y[id]   = entities.pos_y[last];
+    entities.dir_x[id]   = entities.dir_x[last];
+    entities.dir_y[id]   = entities.dir_y[last];
+    entities.prev_x[id]  = entities.prev_x[last];
+    entities.prev_y[id]  = entities.prev_y[last];
+    entities.sprite[id]  = entities.sprite[last];
+    entities.drawn_x[id] = entities.drawn_x[last];
+    entities.drawn_y[id] = entities.drawn_y[last];
+}
+
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+void entity_erase_all(void)
+{
+    for (int i = 0; i < entities.count; i++)
+    {
+        P_Sprite s = sprites[entities.sprite[i]];
+        fb_erase(s->rows, s->n_rows, entities.drawn_x[i], entities.drawn_y[i]);
+    }
+}
+
+
+void entity_draw_all(fixed alpha)
+{
+    for (int i = 0; i < entities.count; i++)
+    {
+        P_Sprite s = sprites[entities.sprite[i]];
+        int      x = FX_TO_INT(FX_LERP(entities.prev_x[i], entities.pos_x[i], alpha));
+        int      y = FX_TO_INT(FX_LERP(entities.prev_y[i], entities.pos_y[i], alpha));
+
+        fb_blit(s->rows, s->n_rows, x, y);
+        entities.drawn_x[i] = x;
+        entities.drawn_y[i] = y;
+    }
+}
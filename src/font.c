@@ -0,0 +1,171 @@
+#include "font.h"
+
+// =============================================================================
+//                         INCLUDES & PRE-PROCESSOR
+
+#include "framebuffer.h"
+#include "typedef.h"
+
+
+// =============================================================================
+//                                GLOBAL DATA
+
+// From ' ' to 'Z'. The row masks read mirrored, as bit 0 is the left column.
+static const u8 small_glyphs[][5] =
+{
+    { 0x0, 0x0, 0x0, 0x0, 0x0 },  // ' '
+    { 0x2, 0x2, 0x2, 0x0, 0x2 },  // '!'
+    { 0x5, 0x5, 0x0, 0x0, 0x0 },  // '"'
+    { 0x5, 0x7, 0x5, 0x7, 0x5 },  // '#'
+    { 0x6, 0x3, 0x2, 0x6, 0x3 },  // '$'
+    { 0x5, 0x4, 0x2, 0x1, 0x5 },  // '%'
+    { 0x2, 0x5, 0x2, 0x5, 0x6 },  // '&'
+    { 0x2, 0x2, 0x0, 0x0, 0x0 },  // '\''
+    { 0x4, 0x2, 0x2, 0x2, 0x4 },  // '('
+    { 0x1, 0x2, 0x2, 0x2, 0x1 },  // ')'
+    { 0x0, 0x5, 0x2, 0x5, 0x0 },  // '*'
+    { 0x0, 0x2, 0x7, 0x2, 0x0 },  // '+'
+    { 0x0, 0x0, 0x0, 0x2, 0x1 },  // ','
+    { 0x0, 0x0, 0x7, 0x0, 0x0 },  // '-'
+    { 0x0, 0x0, 0x0, 0x0, 0x2 },  // '.'
+    { 0x4, 0x4, 0x2, 0x1, 0x1 },  // '/'
+    { 0x7, 0x5, 0x5, 0x5, 0x7 },  // '0'
+    { 0x2, 0x3, 0x2, 0x2, 0x7 },  // '1'
+    { 0x7, 0x4, 0x7, 0x1, 0x7 },  // '2'
+    { 0x7, 0x4, 0x6, 0x4, 0x7 },  // '3'
+    { 0x5, 0x5, 0x7, 0x4, 0x4 },  // '4'
+    { 0x7, 0x1, 0x7, 0x4, 0x7 },  // '5'
+    { 0x7, 0x1, 0x7, 0x5, 0x7 },  // '6'
+    { 0x7, 0x4, 0x2, 0x2, 0x2 },  // '7'
+    { 0x7, 0x5, 0x7, 0x5, 0x7 },  // '8'
+    { 0x7, 0x5, 0x7, 0x4, 0x7 },  // '9'
+    { 0x0, 0x2, 0x0, 0x2, 0x0 },  // ':'
+    { 0x0, 0x2, 0x0, 0x2, 0x1 },  // ';'
+    { 0x4, 0x2, 0x1, 0x2, 0x4 },  // '<'
+    { 0x0, 0x7, 0x0, 0x7, 0x0 },  // '='
+    { 0x1, 0x2, 0x4, 0x2, 0x1 },  // '>'
+    { 0x7, 0x4, 0x2, 0x0, 0x2 },  // '?'
+    { 0x7, 0x5, 0x7, 0x1, 0x6 },  // '@'
+    { 0x2, 0x5, 0x7, 0x5, 0x5 },  // 'A'
+    { 0x3, 0x5, 0x3, 0x5, 0x3 },  // 'B'
+    { 0x6, 0x1, 0x1, 0x1, 0x6 },  // 'C'
+    { 0x3, 0x5, 0x5, 0x5, 0x3 },  // 'D'
+    { 0x7, 0x1, 0x3, 0x1, 0x7 },  // 'E'
+    { 0x7, 0x1, 0x3, 0x1, 0x1 },  // 'F'
+    { 0x6, 0x1, 0x5, 0x5, 0x6 },  // 'G'
+    { 0x5, 0x5, 0x7, 0x5, 0x5 },  // 'H'
+    { 0x7, 0x2, 0x2, 0x2, 0x7 },  // 'I'
+    { 0x4, 0x4, 0x4, 0x5, 0x2 },  // 'J'
+    { 0x5, 0x5, 0x3, 0x5, 0x5 },  // 'K'
+    { 0x1, 0x1, 0x1, 0x1, 0x7 },  // 'L'
+    { 0x5, 0x7, 0x7, 0x5, 0x5 },  // 'M'
+    { 0x3, 0x5, 0x5, 0x5, 0x5 },  // 'N'
+    { 0x2, 0x5, 0x5, 0x5, 0x2 },  // 'O'
+    { 0x3, 0x5, 0x3, 0x1, 0x1 },  // 'P'
+    { 0x2, 0x5, 0x5, 0x3, 0x6 },  // 'Q'
+    { 0x3, 0x5, 0x3, 0x5, 0x5 },  // 'R'
+    { 0x6, 0x1, 0x2, 0x4, 0x3 },  // 'S'
+    { 0x7, 0x2, 0x2, 0x2, 0x2 },  // 'T'
+    { 0x5, 0x5, 0x5, 0x5, 0x7 },  // 'U'
+    { 0x5, 0x5, 0x5, 0x5, 0x2 },  // 'V'
+    { 0x5, 0x5, 0x7, 0x7, 0x5 },  // 'W'
+    { 0x5, 0x5, 0x2, 0x5, 0x5 },  // 'X'
+    { 0x5, 0x5, 0x2, 0x2, 0x2 },  // 'Y'
+    { 0x7, 0x4, 0x2, 0x1, 0x7 },  // 'Z'
+};
+
+const Font font_small =
+{
+    &small_glyphs[0][0], 3, 5, 1, ' ', sizeof small_glyphs / sizeof small_glyphs[0]
+};
+
+
+// From '0' to '9'.
+static const u8 digit_glyphs[][10] =
+{
+    { 0x1E, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x1E },  // '0'
+    { 0x0C, 0x0E, 0x0F, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x3F },  // '1'
+    { 0x1E, 0x33, 0x30, 0x30, 0x18, 0x0C, 0x06, 0x03, 0x03, 0x3F },  // '2'
+    { 0x1E, 0x33, 0x30, 0x30, 0x1C, 0x30, 0x30, 0x30, 0x33, 0x1E },  // '3'
+    { 0x18, 0x1C, 0x1E, 0x1B, 0x1B, 0x3F, 0x18, 0x18, 0x18, 0x18 },  // '4'
+    { 0x3F, 0x03, 0x03, 0x1F, 0x30, 0x30, 0x30, 0x30, 0x33, 0x1E },  // '5'
+    { 0x1E, 0x33, 0x03, 0x03, 0x1F, 0x33, 0x33, 0x33, 0x33, 0x1E },  // '6'
+    { 0x3F, 0x30, 0x30, 0x18, 0x18, 0x0C, 0x0C, 0x06, 0x06, 0x06 },  // '7'
+    { 0x1E, 0x33, 0x33, 0x33, 0x1E, 0x33, 0x33, 0x33, 0x33, 0x1E },  // '8'
+    { 0x1E, 0x33, 0x33, 0x33, 0x33, 0x3E, 0x30, 0x30, 0x33, 0x1E },  // '9'
+};
+
+const Font font_digits =
+{
+    &digit_glyphs[0][0], 6, 10, 2, '0', sizeof digit_glyphs / sizeof digit_glyphs[0]
+};
+
+
+// =============================================================================
+//                                 FUNCTIONS
+
+/**
+ * @brief Return the row masks of the glyph for a character, or NULL if the
+ *        font has none.
+ */
+static const u8 *glyph(const Font *font, char c)
+{
+    // Fonts without lower case letters show them in upper case.
+    if (c >= 'a' && c <= 'z' && font->first + font->count <= 'a')
+        c -= 'a' - 'A';
+
+    int index = c - font->first;
+    if (index < 0 || index >= font->count)
+        return NULL;
+
+    return &font->glyphs[index * font->height];
+}
+
+
+int font_text_width(const Font *font, const char *text)
+{
+    int n = 0;
+    while (text[n])
+        n++;
+
+    return n ? n * (font->width + font->spacing) - font->spacing : 0;
+}
+
+
+/**
+ * @brief The string is clipped to the width of the screen, so a row fits in
+ *        FB_WORDS words. A glyph straddles at most two of them.
+ */
+int font_draw(const Font *font, const char *text, int x, int y)
+{
+    int width = font_text_width(font, text);
+    if (width > FB_WIDTH)
+        width = FB_WIDTH;
+
+    for (int r = 0; r < font->height; r++)
+    {
+        u32 line[FB_WORDS] = { 0 };
+        int pos = 0;
+
+        for (const char *c = text; *c && pos < width; c++)
+        {
+            const u8 *g = glyph(font, *c);
+
+            if (g && g[r])
+            {
+                int w     = pos >> 5;
+                int shift = pos & 31;
+
+                line[w] |= (u32)g[r] << shift;
+                if (shift && w + 1 < FB_WORDS)
+                    line[w + 1] |= (u32)g[r] >> (32 - shift);
+            }
+
+            pos += font->width + font->spacing;
+        }
+
+        fb_write_span(line, width, x, y + r);
+    }
+
+    return width;
+}
@@ -0,0 +1,444 @@
+#include "framebuffer.h"
+
+// =============================================================================
+//                         INCLUDES & PRE-PROCESSOR
+
+#include "display_driver.h"
+#include "render_queue.h"
+#include "typedef.h"
+
+
+// The most unchanged columns between two changed ones that are sent rather
+// than skipped. Skipping costs an instruction to move the address, the same
+// as sending a column.
+#define FLUSH_MAX_GAP 1
+
+
+// =============================================================================
+//                                GLOBAL DATA
+
+u32 framebuffer[FB_HEIGHT][FB_WORDS];
+
+// What the display is currently showing. Compared against `framebuffer` on
+// each flush to find the pixels that need to be transmitted.
+static u32 shown[FB_HEIGHT][FB_WORDS];
+
+// The dirty rectangle, in rows and words. Empty when dirty_y0 > dirty_y1.
+static int dirty_y0 = FB_HEIGHT;
+static int dirty_y1 = -1;
+static int dirty_w0 = FB_WORDS;
+static int dirty_w1 = -1;
+
+
+// =============================================================================
+//                                 FUNCTIONS
+
+/**
+ * @brief Grow the dirty rectangle to include a word of the framebuffer.
+ */
+static void mark_dirty(int row, int word)
+{
+    if (row  < dirty_y0) dirty_y0 = row;
+    if (row  > dirty_y1) dirty_y1 = row;
+    if (word < dirty_w0) dirty_w0 = word;
+    if (word > dirty_w1) dirty_w1 = word;
+}
+
+
+/**
+ * @brief Clear the framebuffer and the physical screen. The screen is cleared
+ *        with a single call to the display driver, once the frames that are
+ *        still being sent are out of its way.
+ */
+void fb_clear(void)
+{
+    render_queue_drain();
+
+    for (int y = 0; y < FB_HEIGHT; y++)
+    {
+        for (int w = 0; w < FB_WORDS; w++)
+        {
+            framebuffer[y][w] = 0;
+            shown[y][w]       = 0;
+        }
+    }
+
+    dirty_y0 = FB_HEIGHT;
+    dirty_y1 = -1;
+    dirty_w0 = FB_WORDS;
+    dirty_w1 = -1;
+
+    graphic_clear_screen();
+}
+
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+int fb_pixel_set(int x, int y)
+{
+    x--;
+    y--;
+
+    if ((unsigned)x >= FB_WIDTH || (unsigned)y >= FB_HEIGHT)
+        return 0;
+
+    framebuffer[y][x >> 5] |= 1u << (x & 31);
+    mark_dirty(y, x >> 5);
+
+    return 1;
+}
+
+
+int fb_pixel_clear(int x, int y)
+{
+    x--;
+    y--;
+
+    if ((unsigned)x >= FB_WIDTH || (unsigned)y >= FB_HEIGHT)
+        return 0;
+
+    framebuffer[y][x >> 5] &= ~(1u << (x & 31));
+    mark_dirty(y, x >> 5);
+
+    return 1;
+}
+
+
+bool fb_pixel_get(int x, int y)
+{
+    x--;
+    y--;
+
+    if ((unsigned)x >= FB_WIDTH || (unsigned)y >= FB_HEIGHT)
+        return false;
+
+    return (framebuffer[y][x >> 5] >> (x & 31)) & 1;
+}
+
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+/**
+ * @brief Clip the rectangle to the screen, then OR a mask into each word it
+ *        covers. Only the first and last word of a row need a partial mask.
+ */
+int fb_fill_rect(int x0, int y0, int x1, int y1)
+{
+    if (x0 > x1) { int t = x0; x0 = x1; x1 = t; }
+    if (y0 > y1) { int t = y0; y0 = y1; y1 = t; }
+
+    x0--; y0--;
+    x1--; y1--;
+
+    if (x0 < 0)          x0 = 0;
+    if (y0 < 0)          y0 = 0;
+    if (x1 >= FB_WIDTH)  x1 = FB_WIDTH  - 1;
+    if (y1 >= FB_HEIGHT) y1 = FB_HEIGHT - 1;
+
+    if (x0 > x1 || y0 > y1)
+        return 0;
+
+    int w0 = x0 >> 5;
+    int w1 = x1 >> 5;
+
+    u32 first = ~0u << (x0 & 31);
+    u32 last  = ~0u >> (31 - (x1 & 31));
+
+    for (int y = y0; y <= y1; y++)
+    {
+        if (w0 == w1)
+        {
+            framebuffer[y][w0] |= first & last;
+            continue;
+        }
+
+        framebuffer[y][w0] |= first;
+        for (int w = w0 + 1; w < w1; w++)
+            framebuffer[y][w] = ~0u;
+        framebuffer[y][w1] |= last;
+    }
+
+    // The dirty rectangle only grows, so its corners are enough.
+    mark_dirty(y0, w0);
+    mark_dirty(y1, w1);
+
+    return (x1 - x0 + 1) * (y1 - y0 + 1);
+}
+
+
+int fb_hspan(int x0, int x1, int y)
+{
+    return fb_fill_rect(x0, y, x1, y);
+}
+
+
+int fb_vspan(int x, int y0, int y1)
+{
+    return fb_fill_rect(x, y0, x, y1);
+}
+
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+/**
+ * @brief OR or AND-NOT a bitmap into the framebuffer. A row mask straddles at
+ *        most two words, so each row costs at most two read-modify-writes.
+ */
+static void blit(const u32 *rows, int n_rows, int x, int y, bool set)
+{
+    x--;
+    y--;
+
+    for (int r = 0; r < n_rows; r++)
+    {
+        int row  = y + r;
+        u32 mask = rows[r];
+
+        if ((unsigned)row >= FB_HEIGHT || mask == 0)
+            continue;
+
+        // Clip the part of the row that is left of the screen.
+        int x0 = x;
+        if (x0 < 0)
+        {
+            if (x0 <= -32)
+                continue;
+            mask >>= -x0;
+            x0 = 0;
+        }
+
+        int w     = x0 >> 5;
+        int shift = x0 & 31;
+
+        if (w >= FB_WORDS)
+            continue;
+
+        u32 lo = mask << shift;
+        u32 hi = shift ? mask >> (32 - shift) : 0;
+
+        if (set) framebuffer[row][w] |=  lo;
+        else     framebuffer[row][w] &= ~lo;
+        mark_dirty(row, w);
+
+        if (hi && w + 1 < FB_WORDS)
+        {
+            if (set) framebuffer[row][w + 1] |=  hi;
+            else     framebuffer[row][w + 1] &= ~hi;
+            mark_dirty(row, w + 1);
+        }
+    }
+}
+
+
+void fb_blit(const u32 *rows, int n_rows, int x, int y)
+{
+    blit(rows, n_rows, x, y, true);
+}
+
+
+void fb_erase(const u32 *rows, int n_rows, int x, int y)
+{
+    blit(rows, n_rows, x, y, false);
+}
+
+
+/**
+ * @brief Each word of `bits` straddles at most two words of the row, so each
+ *        costs at most two read-modify-writes, the same as a row of fb_blit().
+ */
+void fb_write_span(const u32 *bits, int width, int x, int y)
+{
+    x--;
+    y--;
+
+    if ((unsigned)y >= FB_HEIGHT)
+        return;
+
+    for (int i = 0; i < width; i += 32)
+    {
+        int n    = width - i < 32 ? width - i : 32;
+        u32 mask = n == 32 ? ~0u : (1u << n) - 1;
+        u32 data = bits[i >> 5] & mask;
+
+        // Clip the part of the word that is left of the screen.
+        int x0 = x + i;
+        if (x0 < 0)
+        {
+            if (x0 <= -32)
+                continue;
+            mask >>= -x0;
+            data >>= -x0;
+            x0 = 0;
+        }
+
+        int w     = x0 >> 5;
+        int shift = x0 & 31;
+
+        if (w >= FB_WORDS)
+            break;
+
+        framebuffer[y][w] = (framebuffer[y][w] & ~(mask << shift)) | data << shift;
+        mark_dirty(y, w);
+
+        if (shift && w + 1 < FB_WORDS && mask >> (32 - shift))
+        {
+            framebuffer[y][w + 1] = (framebuffer[y][w + 1] & ~(mask >> (32 - shift)))
+                                  | data >> (32 - shift);
+            mark_dirty(y, w + 1);
+        }
+    }
+}
+
+
+/**
+ * @brief Place a row of a bitmap, starting at pixel x (0-based), into a full
+ *        framebuffer row. Pixels outside of the screen are dropped.
+ */
+static void place_row(u32 mask, int x, u32 line[FB_WORDS])
+{
+    for (int w = 0; w < FB_WORDS; w++)
+        line[w] = 0;
+
+    if (mask == 0 || x <= -32 || x >= FB_WIDTH)
+        return;
+
+    if (x < 0)
+    {
+        mask >>= -x;
+        x = 0;
+    }
+
+    int w     = x >> 5;
+    int shift = x & 31;
+
+    line[w] = mask << shift;
+    if (shift && w + 1 < FB_WORDS)
+        line[w + 1] = mask >> (32 - shift);
+}
+
+
+void fb_move(const u32 *rows, int n_rows, int x0, int y0, int x1, int y1)
+{
+    x0--; y0--;
+    x1--; y1--;
+
+    int top    = y0 < y1 ? y0 : y1;
+    int bottom = (y0 > y1 ? y0 : y1) + n_rows;
+
+    if (top    < 0)         top    = 0;
+    if (bottom > FB_HEIGHT) bottom = FB_HEIGHT;
+
+    // The words either position can reach. A row mask is at most 32 pixels
+    // wide, so it ends in the word after the one it starts in.
+    int w_first = (x0 < x1 ? x0 : x1) >> 5;
+    int w_last  = ((x0 > x1 ? x0 : x1) >> 5) + 1;
+
+    if (w_first < 0)            w_first = 0;
+    if (w_last  > FB_WORDS - 1) w_last  = FB_WORDS - 1;
+
+    for (int row = top; row < bottom; row++)
+    {
+        int r0 = row - y0;
+        int r1 = row - y1;
+
+        u32 before[FB_WORDS], after[FB_WORDS];
+        place_row(r0 >= 0 && r0 < n_rows ? rows[r0] : 0, x0, before);
+        place_row(r1 >= 0 && r1 < n_rows ? rows[r1] : 0, x1, after);
+
+        for (int w = w_first; w <= w_last; w++)
+        {
+            u32 changed = before[w] ^ after[w];
+
+            if (!changed)
+                continue;
+
+            framebuffer[row][w] = (framebuffer[row][w] & ~(changed & before[w]))
+                                | (changed & after[w]);
+            mark_dirty(row, w);
+        }
+    }
+}
+
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+/**
+ * @brief Build the column bytes of a word-wide strip of a page: bit `r` of
+ *        byte `c` is pixel `c` of row `r` of the page.
+ */
+static void column_bytes(u32 (*rows)[FB_WORDS], int w, u8 bytes[32])
+{
+    for (int c = 0; c < 32; c++)
+    {
+        u8 byte = 0;
+
+        for (int r = 0; r < 8; r++)
+            byte |= ((rows[r][w] >> c) & 1) << r;
+
+        bytes[c] = byte;
+    }
+}
+
+
+/**
+ * @brief Record the columns of each page that differ between the
+ *        framebuffer and the display, submit them to the render queue, then
+ *        reset the dirty rectangle.
+ *
+ *        Changed columns are sent in runs, one bus cycle per column. Short
+ *        gaps of unchanged columns are sent along with them rather than
+ *        moving the address, see FLUSH_MAX_GAP.
+ */
+void fb_flush(void)
+{
+    for (int page = dirty_y0 >> 3; page <= dirty_y1 >> 3; page++)
+    {
+        u32 (*rows)[FB_WORDS]       = &framebuffer[page << 3];
+        u32 (*shown_rows)[FB_WORDS] = &shown[page << 3];
+
+        u32 changed[FB_WORDS] = { 0 };
+        u8  bytes[FB_WIDTH];
+
+        for (int w = dirty_w0; w <= dirty_w1; w++)
+        {
+            for (int r = 0; r < 8; r++)
+            {
+                changed[w]      |= rows[r][w] ^ shown_rows[r][w];
+                shown_rows[r][w] = rows[r][w];
+            }
+
+            if (changed[w])
+                column_bytes(rows, w, &bytes[w << 5]);
+        }
+
+        // Send every run of changed columns.
+        int start = -1;
+        int end   = -1;
+
+        for (int x = dirty_w0 << 5; x < (dirty_w1 + 1) << 5; x++)
+        {
+            if (!((changed[x >> 5] >> (x & 31)) & 1))
+                continue;
+
+            if (start >= 0 && x - end - 1 > FLUSH_MAX_GAP)
+            {
+                render_queue_write_page(page, start, &bytes[start], end - start + 1);
+                start = -1;
+            }
+
+            if (start < 0)
+                start = x;
+            end = x;
+        }
+
+        if (start >= 0)
+            render_queue_write_page(page, start, &bytes[start], end - start + 1);
+    }
+
+    render_queue_submit();
+
+    dirty_y0 = FB_HEIGHT;
+    dirty_y1 = -1;
+    dirty_w0 = FB_WORDS;
+    dirty_w1 = -1;
+}
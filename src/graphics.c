@@ -1,25 +1,35 @@
 #include "graphics.h"
-#include "display_driver.h"
+#include "framebuffer.h"
 #include "typedef.h"
 
 
 /// <summary>
-/// Draw a line.
+/// Draw the pixels of a line, optionally leaving out its end point so that
+/// connected lines don't draw their shared vertices twice.
 /// </summary>
-/// <param name="line">The line that'll be drawn.</param>
-/// <returns>
-/// 1 if the line could be drawn inside the bounds of the screen.
-/// 0, otherwise.
-/// </returns>
-int draw_line(P_Line line)
+/// <returns>The number of pixels drawn inside the bounds of the screen.</returns>
+/// <remarks>
+/// Horizontal and vertical lines are drawn as a single span. Other lines are
+/// walked with Bresenham's algorithm along their major axis, and each run of
+/// pixels that share a minor coordinate is drawn as one span.
+/// </remarks>
+static int draw_segment(int x0, int y0, int x1, int y1, bool skip_end)
 {
-    i8 x0, y0, x1, y1;
+    if (skip_end && x0 == x1 && y0 == y1)
+        return 0;
 
-    x0 = line->p0.x;
-    y0 = line->p0.y;
-
-    x1 = line->p1.x;
-    y1 = line->p1.y;
+    if (y0 == y1)
+    {
+        if (skip_end)
+            x1 += x0 < x1 ? -1 : 1;
+        return fb_hspan(x0, x1, y0);
+    }
+    if (x0 == x1)
+    {
+        if (skip_end)
+            y1 += y0 < y1 ? -1 : 1;
+        return fb_vspan(x0, y0, y1);
+    }
 
     bool steep = abs(y1 - y0) > abs(x1 - x0);
 
@@ -29,34 +39,75 @@ int draw_line(P_Line line)
         swap(&x1, &y1);
     }
 
+    // The end point is the pixel at x1, unless the ends are swapped below.
+    int skip_x = x1;
+
     if (x0 > x1)
     {
         swap(&x0, &x1);
         swap(&y0, &y1);
+        skip_x = x0;
     }
 
-    i8 delta_x = x1 - x0;
-    i8 delta_y = abs(y1 - y0);
+    int delta_x = x1 - x0;
+    int delta_y = abs(y1 - y0);
 
-    i8 error = 0;
-    i8 y     = y0;
+    int error = 0;
+    int y     = y0;
+    int run   = x0;
+    int drawn = 0;
 
-    i8 y_step = y0 < y1 ? 1 : -1;
+    int y_step = y0 < y1 ? 1 : -1;
 
-    for (i8 x = x0; x <= x1; x++)
+    for (int x = x0; x <= x1; x++)
     {
-        if (steep)
-            graphic_pixel_set(y, x);
-        else
-            graphic_pixel_set(x, y);
-
         error += delta_y;
+        if (error < delta_x && x < x1)
+            continue;
+
+        // The run ends here: draw it, then step the minor axis.
+        int first = run;
+        int last  = x;
+
+        if (skip_end && first == skip_x) first++;
+        if (skip_end && last  == skip_x) last--;
+
+        if (first <= last)
+        {
+            if (steep)
+                drawn += fb_vspan(y, first, last);
+            else
+                drawn += fb_hspan(first, last, y);
+        }
+
+        run = x + 1;
+
         if (error >= delta_x)
         {
             y     += y_step;
             error -= delta_x;
         }
     }
+
+    return drawn;
+}
+
+
+/// <summary>
+/// Draw a line.
+/// </summary>
+/// <param name="line">The line that'll be drawn.</param>
+/// <returns>
+/// 1 if the line could be drawn inside the bounds of the screen.
+/// 0, otherwise.
+/// </returns>
+int draw_line(P_Line line)
+{
+    return draw_segment(
+        line->p0.x, line->p0.y,
+        line->p1.x, line->p1.y,
+        false
+    ) > 0;
 }
 
 
@@ -68,55 +119,231 @@ int draw_line(P_Line line)
 /// 1 if the rect could be drawn inside the bounds of the screen.
 /// 0, otherwise.
 /// </returns>
+/// <remarks>
+/// The top and bottom are horizontal spans. The sides are vertical spans
+/// between them, so no pixel is drawn twice.
+/// </remarks>
 int draw_rect(P_Rect rect)
 {
-    i8 p_x    = rect->origin.x;
-    i8 p_y    = rect->origin.y;
-    i8 width  = rect->dimen.x;
-    i8 height = rect->dimen.y;
-
-    // Draw top line
-    Point start = { p_x,         p_y };
-    Point end   = { p_x + width, p_y };
-
-    Line  line = { start, end };
-    draw_line(&line);
-    // Draw right line
-    line.p0.x = p_x + width;
-    line.p1.y = p_y + height;
-    draw_line(&line);
-    // Draw bottom line
-    line.p0.y = p_y + height;
-    line.p0.x = p_x;
-    draw_line(&line);
-    // Draw left line
-    line.p1.x = p_x;
-    line.p1.y = p_y;
-    draw_line(&line);
+    int x0 = rect->origin.x;
+    int y0 = rect->origin.y;
+    int x1 = x0 + rect->dimen.x;
+    int y1 = y0 + rect->dimen.y;
+
+    if (y0 > y1)
+        swap(&y0, &y1);
+
+    int drawn = fb_hspan(x0, x1, y0);
+
+    if (y1 > y0)
+        drawn += fb_hspan(x0, x1, y1);
+
+    if (y1 - y0 > 1)
+    {
+        drawn += fb_vspan(x0, y0 + 1, y1 - 1);
+        if (x1 != x0)
+            drawn += fb_vspan(x1, y0 + 1, y1 - 1);
+    }
+
+    return drawn > 0;
+}
+
+
+/// <summary>
+/// Draw a filled rect.
+/// </summary>
+/// <param name="rect">The rect that'll be filled.</param>
+/// <returns>
+/// 1 if the rect could be drawn inside the bounds of the screen.
+/// 0, otherwise.
+/// </returns>
+/// <remarks>Covers the same pixels as draw_rect(), including its outline.</remarks>
+int fill_rect(P_Rect rect)
+{
+    int x0 = rect->origin.x;
+    int y0 = rect->origin.y;
+
+    return fb_fill_rect(x0, y0, x0 + rect->dimen.x, y0 + rect->dimen.y) > 0;
 }
 
 
 /// <summary>
-/// Draw a polygon.
+/// Draw the outline of a polygon.
 /// </summary>
 /// <param name="poly">The polygon that'll be drawn.</param>
 /// <returns>
 /// 1 if the polygon could be drawn inside the bounds of the screen.
 /// 0, otherwise.
 /// </returns>
-int draw_poly(P_PolyPoint poly)
+/// <remarks>
+/// Every edge leaves out its end point, which is drawn as the start of the
+/// next edge instead. The last vertex is also drawn on its own: an open
+/// polygon has no edge from it, and a closed one whose vertices all coincide
+/// has only edges of zero length, which draw nothing.
+/// </remarks>
+int draw_poly(P_Polygon poly)
+{
+    const Point *p = poly->points;
+    int          n = poly->count;
+
+    if (n <= 0)
+        return 0;
+
+    int drawn = 0;
+
+    for (int i = 0; i + 1 < n; i++)
+        drawn += draw_segment(p[i].x, p[i].y, p[i + 1].x, p[i + 1].y, true);
+
+    if (poly->closed && n > 1)
+        drawn += draw_segment(p[n - 1].x, p[n - 1].y, p[0].x, p[0].y, true);
+
+    drawn += fb_pixel_set(p[n - 1].x, p[n - 1].y);
+
+    return drawn > 0;
+}
+
+
+/// <summary>
+/// An edge of a polygon, for the scanline fill. `x` is where the edge
+/// crosses the current scanline, in 16.16 fixed-point.
+/// </summary>
+typedef struct
+{
+    int y_top;  // The first scanline the edge crosses.
+    int y_end;  // The scanline after the last one it crosses.
+    i32 x;
+    i32 step;   // The change of x per scanline.
+} Edge;
+
+// Kept out of the stack, which only has room for a few hundred bytes.
+static Edge  edge_table[POLY_MAX_VERTICES];
+static Edge *active[POLY_MAX_VERTICES];
+
+
+/// <summary>
+/// Fill a polygon, including its outline.
+/// </summary>
+/// <param name="poly">The polygon that'll be filled.</param>
+/// <returns>
+/// 1 if the polygon could be drawn inside the bounds of the screen.
+/// 0, otherwise.
+/// </returns>
+/// <remarks>
+/// The polygon is always filled as if it were closed. The edges are sorted by
+/// their top scanline into an edge table. Walking down the screen, edges move
+/// from the table to the active list as the scanline reaches them, and the
+/// active list is kept sorted by x. Each pair of active edges bounds one
+/// horizontal span of the scanline. The outline is drawn last, so the edges
+/// themselves are always covered.
+/// </remarks>
+int fill_poly(P_Polygon poly)
 {
-    Point p0 = { poly->x, poly->y };
-    P_PolyPoint next = poly->next;
-    while (next)
+    const Point *p = poly->points;
+    int          n = poly->count;
+
+    if (n > POLY_MAX_VERTICES)
+        n = POLY_MAX_VERTICES;
+
+    // Build the edge table, sorted by top scanline. Horizontal edges don't
+    // cross any scanline and are left to the outline.
+    int n_edges = 0;
+    int y_min   = FB_HEIGHT + 1;
+    int y_max   = 0;
+
+    for (int i = 0; i < n; i++)
     {
-        Point p1 = { next->x, next->y };
-        Line  l  = { p0, p1 };
-        draw_line(&l);
-        p0.x = p1.x;
-        p0.y = p1.y;
-        next = next->next;
+        Point a = p[i];
+        Point b = p[(i + 1) % n];
+
+        if (a.y == b.y)
+            continue;
+        if (a.y > b.y)
+        {
+            Point t = a;
+            a = b;
+            b = t;
+        }
+
+        Edge e =
+        {
+            a.y,
+            b.y,
+            (i32)a.x << 16,
+            (((i32)(b.x - a.x)) << 16) / (b.y - a.y)
+        };
+
+        int j = n_edges++;
+        while (j > 0 && edge_table[j - 1].y_top > e.y_top)
+        {
+            edge_table[j] = edge_table[j - 1];
+            j--;
+        }
+        edge_table[j] = e;
+
+        if (a.y < y_min) y_min = a.y;
+        if (b.y > y_max) y_max = b.y;
     }
+
+    if (y_min < 1)         y_min = 1;
+    if (y_max > FB_HEIGHT) y_max = FB_HEIGHT + 1;
+
+    int drawn    = 0;
+    int n_active = 0;
+    int next     = 0;
+
+    for (int y = y_min; y < y_max; y++)
+    {
+        // Drop the edges that ended above this scanline.
+        int kept = 0;
+        for (int i = 0; i < n_active; i++)
+            if (active[i]->y_end > y)
+                active[kept++] = active[i];
+        n_active = kept;
+
+        // Activate the edges that start on or above it. An edge that starts
+        // above the screen is moved down to the first scanline.
+        while (next < n_edges && edge_table[next].y_top <= y)
+        {
+            Edge *e = &edge_table[next++];
+
+            if (e->y_end <= y)
+                continue;
+
+            e->x += e->step * (y - e->y_top);
+            active[n_active++] = e;
+        }
+
+        // The edges move little between scanlines, so insertion sort is
+        // close to linear.
+        for (int i = 1; i < n_active; i++)
+        {
+            Edge *e = active[i];
+            int   j = i;
+
+            while (j > 0 && active[j - 1]->x > e->x)
+            {
+                active[j] = active[j - 1];
+                j--;
+            }
+            active[j] = e;
+        }
+
+        for (int i = 0; i + 1 < n_active; i += 2)
+        {
+            int x0 = (active[i    ]->x + 0x8000) >> 16;
+            int x1 = (active[i + 1]->x + 0x8000) >> 16;
+
+            drawn += fb_hspan(x0, x1, y);
+        }
+
+        for (int i = 0; i < n_active; i++)
+            active[i]->x += active[i]->step;
+    }
+
+    Polygon outline = { p, n, true };
+    drawn += draw_poly(&outline);
+
+    return drawn > 0;
 }
 
 
@@ -128,12 +355,12 @@ int draw_poly(P_PolyPoint poly)
 /// </param>
 void draw_object(P_Object obj)
 {
-    const int x = obj->pos_x;
-    const int y = obj->pos_y;
-    P_Point   arr = obj->geo->px;
+    P_Sprite sprite = obj->sprite;
+
+    obj->drawn_x = FX_TO_INT(obj->pos_x);
+    obj->drawn_y = FX_TO_INT(obj->pos_y);
 
-    for (char i = 0; i < MAX_SIZE; i++)
-        graphic_pixel_set(x + arr[i].x, y + arr[i].y);
+    fb_blit(sprite->rows, sprite->n_rows, obj->drawn_x, obj->drawn_y);
 }
 
 
@@ -143,23 +370,66 @@ void draw_object(P_Object obj)
 /// <param name="obj">The object whose pixels to delete.</param>
 void clear_object(P_Object obj)
 {
-    const int x = obj->pos_x;
-    const int y = obj->pos_y;
-    P_Point   arr = obj->geo->px;
-    const char max_size = MAX_SIZE;
+    P_Sprite sprite = obj->sprite;
+
+    fb_erase(sprite->rows, sprite->n_rows, obj->drawn_x, obj->drawn_y);
+}
+
+
+/// <summary>
+/// Draw an object between its previous and current position.
+/// </summary>
+/// <param name="obj">The object to draw.</param>
+/// <param name="alpha">How far between the positions, from 0 to FX_ONE.</param>
+/// <remarks>
+/// The object is moved from where it was last drawn with fb_move(), which only
+/// turns off the pixels it leaves. Erasing a ball that overlapped it also
+/// turns off some of its pixels, so it is blitted again at the new position.
+/// </remarks>
+void draw_object_between(P_Object obj, fixed alpha)
+{
+    P_Sprite sprite = obj->sprite;
+
+    int x = FX_TO_INT(FX_LERP(obj->prev_x, obj->pos_x, alpha));
+    int y = FX_TO_INT(FX_LERP(obj->prev_y, obj->pos_y, alpha));
+
+    if (x != obj->drawn_x || y != obj->drawn_y)
+        fb_move(sprite->rows, sprite->n_rows, obj->drawn_x, obj->drawn_y, x, y);
+
+    fb_blit(sprite->rows, sprite->n_rows, x, y);
+
+    obj->drawn_x = x;
+    obj->drawn_y = y;
+}
+
+
+/// <summary>
+/// Compute the bounds of the set pixels of a sprite.
+/// </summary>
+/// <param name="sprite">The sprite whose width and height to set.</param>
+void sprite_init(P_Sprite sprite)
+{
+    u32 columns = 0;
+
+    sprite->height = 0;
+    for (int r = 0; r < sprite->n_rows; r++)
+    {
+        columns |= sprite->rows[r];
+        if (sprite->rows[r])
+            sprite->height = r + 1;
+    }
 
-    for (int i = 0; i < max_size; i++)
-        graphic_pixel_clear(x + arr[i].x, y + arr[i].y);
+    sprite->width = columns ? 32 - __builtin_clz(columns) : 0;
 }
 
 
 /// <summary>
-/// Get the absolute value of a char.
+/// Get the absolute value of an integer.
 /// </summary>
 /// <param name="nr">
 /// The value to retrieve the absolute value from.
 /// </param>
-i8 abs(i8 nr)
+int abs(int nr)
 {
     if (nr < 0) return -nr;
     return nr;
@@ -167,11 +437,11 @@ i8 abs(i8 nr)
 
 
 /// <summary>
-/// Swap the values of two chars.
+/// Swap the values of two integers.
 /// </summary>
-void swap(i8 *a, i8 *b)
+void swap(int *a, int *b)
 {
-    char temp = *a;
+    int temp = *a;
     *a = *b;
     *b = temp;
 }
\ No newline at end of file
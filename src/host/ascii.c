@@ -0,0 +1,118 @@
+#include "ascii.h"
+
+#include <stdio.h>
+
+#include "ascii_queue.h"
+#include "delay.h"
+#include "host.h"
+
+
+// The display data RAM of the emulated HD44780. Row 1 starts at address 0x00
+// and row 2 at address 0x40.
+static u8 ddram[0x80];
+static u8 address = 0;
+
+
+// The virtual time when the controller finishes the instruction it was sent
+// last. Until then, the busy flag is set.
+static u64 busy_until = 0;
+
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool ascii_busy(void)
+{
+    return host_time_ns < busy_until;
+}
+
+
+/**
+ * @brief Execute an instruction on the emulated controller. Only the
+ *        instructions used by the game have a visible effect.
+ */
+void ascii_write_cmd(u8 cmd)
+{
+    host_stats.text_command++;
+
+    if (cmd & 0x80)
+        address = cmd & 0x7F;
+    else if (cmd == 0x01)
+    {
+        for (u32 i = 0; i < sizeof ddram; i++)
+            ddram[i] = ' ';
+        address = 0;
+    }
+
+    busy_until = host_time_ns + (cmd < 0x04 ? ASCII_EXEC_SLOW_US : 37) * 1000;
+}
+
+
+/**
+ * @brief Write a character at the current address of the emulated
+ *        controller. The address is incremented afterwards.
+ */
+void ascii_write_data(u8 data)
+{
+    host_stats.text_data++;
+
+    ddram[address] = data;
+    address = (address + 1) & 0x7F;
+
+    busy_until = host_time_ns + 41 * 1000;
+}
+
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+void ascii_command(
+    u8 cmd,
+    void(*delay_func)(u32),
+    u32  delay_dur
+)
+{
+    while ( ascii_busy() )
+        host_advance(1000);
+
+    delay_mikro     (     8     );
+    ascii_write_cmd (    cmd    );
+    delay_func      ( delay_dur );
+}
+
+
+void ascii_data(
+    u8 cmd,
+    void(*delay_func)(u32),
+    u32  delay_dur
+)
+{
+    while ( ascii_busy() )
+        host_advance(1000);
+
+    delay_mikro      (     8     );
+    ascii_write_data (    cmd    );
+    delay_func       ( delay_dur );
+}
+
+
+void ascii_init(void)
+{
+    ascii_command(0b00111000, delay_mikro, 40);
+    ascii_command(0b00001110, delay_mikro, 40);
+    ascii_command(0b00000001, delay_milli,  2);
+    ascii_command(0b00000100, delay_mikro, 40);
+}
+
+
+void host_ascii_dump(void)
+{
+    for (u32 row = 0; row < 2; row++)
+    {
+        putchar('|');
+        for (u32 col = 0; col < 20; col++)
+        {
+            u8 c = ddram[row * 0x40 + col];
+            putchar(c >= ' ' && c < 0x7F ? c : ' ');
+        }
+        puts("|");
+    }
+}
@@ -0,0 +1,35 @@
+#include "clock.h"
+
+#include "host.h"
+
+
+void clock_init(void)
+{
+}
+
+
+/**
+ * @brief The clock of the host is the virtual clock, in nanoseconds.
+ */
+u32 now(void)
+{
+    return (u32)host_time_ns;
+}
+
+
+u32 clock_ticks_per_us(void)
+{
+    return 1000;
+}
+
+
+/**
+ * @brief Advance the virtual clock to the deadline instead of spinning.
+ */
+void delay_until(u32 deadline)
+{
+    i32 left = (i32)(deadline - now());
+
+    if (left > 0)
+        host_advance(left);
+}
@@ -0,0 +1,27 @@
+#include "cycles.h"
+
+#include <time.h>
+
+
+void cycles_init(void)
+{
+}
+
+
+/**
+ * @brief The host counts real nanoseconds, not virtual time, so the profiler
+ *        measures how long the code takes to run on the host.
+ */
+u32 cycles_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (u32)(ts.tv_sec * 1000000000ull + ts.tv_nsec);
+}
+
+
+u32 cycles_per_us(void)
+{
+    return 1000;
+}
@@ -0,0 +1,239 @@
+#include "host.h"
+
+// =============================================================================
+//                         INCLUDES & PRE-PROCESSOR
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "hal.h"
+#include "render_queue.h"
+#include "replay.h"
+#include "ticker.h"
+
+
+// The longest keypad script that can be loaded.
+#define MAX_SCRIPT 1024
+
+
+// =============================================================================
+//                                GLOBAL DATA
+
+HostStats host_stats;
+u64       host_time_ns;
+
+static u64  run_ns = 60000ull * 1000000;
+static bool dump   = false;
+
+static struct timespec wall_start;
+
+// The file the input log is recorded to, if any.
+static FILE *record_file = NULL;
+
+
+/**
+ * @brief One step of the keypad script: which keys are held from a given
+ *        point in time.
+*/
+typedef struct
+{
+    u64 at_ns;
+    u16 keys;
+} KeyStep;
+
+static KeyStep script[MAX_SCRIPT] =
+{
+    {                 0, 1 << 5 },
+    { 100ull * 1000000,      0  },
+};
+static int script_len  = 2;
+static int script_step = 0;
+
+
+// =============================================================================
+//                                 FUNCTIONS
+
+/**
+ * @brief Load a keypad script, replacing the default one.
+ */
+static void load_script(const char *path)
+{
+    FILE *f = fopen(path, "r");
+    if (!f)
+    {
+        fprintf(stderr, "host: cannot open keypad script '%s'\n", path);
+        exit(1);
+    }
+
+    char line[128];
+    script_len = 0;
+
+    while (fgets(line, sizeof line, f) && script_len < MAX_SCRIPT)
+    {
+        unsigned long long ms;
+        char keys[32];
+
+        if (line[0] == '#' || sscanf(line, "%llu %31s", &ms, keys) != 2)
+            continue;
+
+        u16 mask = 0;
+        for (char *k = keys; *k && *k != '-'; k++)
+        {
+            int v = (*k >= '0' && *k <= '9') ? *k - '0'
+                  : (*k >= 'a' && *k <= 'f') ? *k - 'a' + 10
+                  : (*k >= 'A' && *k <= 'F') ? *k - 'A' + 10
+                  : -1;
+            if (v >= 0)
+                mask |= 1 << v;
+        }
+
+        script[script_len++] = (KeyStep){ ms * 1000000, mask };
+    }
+
+    fclose(f);
+}
+
+
+/**
+ * @brief Read a whole file into memory. The buffer is never freed.
+ */
+static char *load_file(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f)
+    {
+        fprintf(stderr, "host: cannot open '%s'\n", path);
+        exit(1);
+    }
+
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    char *text = malloc(size + 1);
+    size = fread(text, 1, size, f);
+    text[size] = '\0';
+
+    fclose(f);
+    return text;
+}
+
+
+static void record_line(const char *line)
+{
+    fputs(line, record_file);
+}
+
+
+/**
+ * @brief The host has no clocks or ports to bring up. Read the run
+ *        configuration from the environment instead.
+ */
+void app_init(void)
+{
+    const char *s;
+
+    uart_init();
+
+    if ((s = getenv("PONG_RUN_MS")))
+        run_ns = strtoull(s, NULL, 10) * 1000000;
+    if ((s = getenv("PONG_KEYS")))
+        load_script(s);
+    dump = getenv("PONG_DUMP") != NULL;
+
+    if ((s = getenv("PONG_REPLAY")))
+        replay_load(load_file(s));
+    else if ((s = getenv("PONG_RECORD")))
+    {
+        if (!(record_file = fopen(s, "w")))
+        {
+            fprintf(stderr, "host: cannot create '%s'\n", s);
+            exit(1);
+        }
+        replay_record_to(record_line);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &wall_start);
+    clock_init();
+}
+
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+/**
+ * @brief Print the report of the run and exit.
+ */
+void app_finish(void)
+{
+    struct timespec wall_end;
+    clock_gettime(CLOCK_MONOTONIC, &wall_end);
+
+    double wall_ms = (wall_end.tv_sec  - wall_start.tv_sec)  * 1e3
+                   + (wall_end.tv_nsec - wall_start.tv_nsec) / 1e6;
+    double virt_ms = host_time_ns / 1e6;
+
+    if (dump)
+    {
+        host_display_dump();
+        host_ascii_dump();
+    }
+
+    printf("virtual_ms=%.3f\n",      virt_ms);
+    printf("wall_ms=%.3f\n",         wall_ms);
+    printf("speedup=%.1f\n",         wall_ms > 0 ? virt_ms / wall_ms : 0.0);
+    printf("display_command=%llu\n", host_stats.display_command);
+    printf("display_data=%llu\n",    host_stats.display_data);
+    printf("display_read=%llu\n",    host_stats.display_read);
+    printf("text_command=%llu\n",    host_stats.text_command);
+    printf("text_data=%llu\n",       host_stats.text_data);
+    printf("row_scans=%llu\n",       host_stats.row_scans);
+    printf("ticks=%u\n",             ticker_stats.ticks);
+    printf("frames=%u\n",            ticker_stats.frames);
+    printf("overruns=%u\n",          ticker_stats.overruns);
+    printf("dropped=%u\n",           ticker_stats.dropped);
+    printf("render_frames=%u\n",     render_stats.frames);
+    printf("render_bytes=%u\n",      render_stats.bytes);
+    printf("render_stalls=%u\n",     render_stats.stalls);
+    printf("render_max_pending=%u\n", render_stats.max_pending);
+
+    if (replay_active())
+    {
+        printf("replay_frames=%u\n",         replay_stats.frames);
+        printf("replay_checks=%u\n",         replay_stats.checks);
+        printf("replay_mismatches=%u\n",     replay_stats.mismatches);
+        printf("replay_first_mismatch=%u\n", replay_stats.first_mismatch);
+        printf("replay_hash=%08x\n",         replay_stats.hash);
+    }
+
+    if (record_file)
+    {
+        replay_flush();
+        fclose(record_file);
+    }
+
+    exit(0);
+}
+
+
+void host_advance(u64 ns)
+{
+    host_time_ns += ns;
+    host_timer_update();
+
+    if (host_time_ns >= run_ns)
+        app_finish();
+}
+
+
+u16 host_keys_held(void)
+{
+    while (script_step + 1 < script_len
+        && script[script_step + 1].at_ns <= host_time_ns)
+        script_step++;
+
+    if (script_len == 0 || script[script_step].at_ns > host_time_ns)
+        return 0;
+
+    return script[script_step].keys;
+}
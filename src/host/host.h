@@ -0,0 +1,78 @@
+#ifndef __HOST_H__
+#define __HOST_H__
+
+#include "typedef.h"
+
+/*
+ * Native PC backend of the hardware abstraction layer (see hal.h).
+ *
+ * Time is virtual: it only advances when the game delays or touches the
+ * hardware, so the game runs as fast as the host can execute it. The run ends
+ * once `PONG_RUN_MS` milliseconds of virtual time have passed, at which point
+ * a report is printed to stdout.
+ *
+ * Environment variables:
+ *   PONG_RUN_MS  Virtual duration of the run, in milliseconds (default 60000).
+ *   PONG_KEYS    Keypad script. Each line is `<ms> <keys>`, where <keys> is a
+ *                string of hex digits naming the keys held from <ms> on, or
+ *                `-` for none. Lines starting with `#` are ignored. Without a
+ *                script, 5 is held for the first 100 ms to start the game.
+ *   PONG_DUMP    If set, print the graphic and text displays in the report.
+ *   PONG_RECORD  Record the input of the run to this file, see replay.h.
+ *   PONG_REPLAY  Drive the game from an input log instead of the keypad. The
+ *                game runs without waiting for the ticker, and the run ends
+ *                when the log does, with the result of the replay in the
+ *                report.
+ */
+
+typedef unsigned long long u64;
+
+
+/**
+ * @brief Counters of all hardware operations performed by the game.
+*/
+typedef struct
+{
+    u64 display_command;  // Instructions sent to the graphic display.
+    u64 display_data;     // Column bytes written to the graphic display.
+    u64 display_read;     // Column bytes read from the graphic display.
+    u64 text_command;     // Commands sent to the text display.
+    u64 text_data;        // Characters sent to the text display.
+    u64 row_scans;        // Keypad rows read.
+} HostStats;
+
+extern HostStats host_stats;
+
+
+/**
+ * @brief The virtual time since start-up, in nanoseconds.
+*/
+extern u64 host_time_ns;
+
+
+/**
+ * @brief Advance the virtual clock. Ends the run if its duration is exceeded.
+*/
+void host_advance(u64 ns);
+
+
+/**
+ * @brief Run the timer interrupt for every period that has passed on the
+ *        virtual clock.
+*/
+void host_timer_update(void);
+
+
+/**
+ * @brief Return the keys held at the current virtual time, as a bitmask
+ *        indexed by key value.
+*/
+u16 host_keys_held(void);
+
+
+// Display emulation, printed by the report when PONG_DUMP is set.
+void host_display_dump(void);
+void host_ascii_dump(void);
+
+
+#endif // __HOST_H__
@@ -0,0 +1,35 @@
+#include "keyb.h"
+
+#include "host.h"
+
+
+static u32 active_row = 0;
+
+
+void activate_row(u32 row)
+{
+    active_row = row;
+}
+
+
+/**
+ * @brief Read the active row of the scripted keypad. Each read takes 250 ns
+ *        of virtual time, which roughly matches a GPIO access on the board.
+ */
+u8 read_columns(void)
+{
+    host_stats.row_scans++;
+    host_advance(250);
+
+    if (active_row < 1 || active_row > 4)
+        return 0;
+
+    u16 keys = host_keys_held();
+    u8  c    = 0;
+
+    for (u32 col = 0; col < 4; col++)
+        if (keys & (1 << KEYCODE[active_row - 1][col]))
+            c |= 1 << col;
+
+    return c;
+}
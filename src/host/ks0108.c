@@ -0,0 +1,114 @@
+#include "ks0108.h"
+
+#include <stdio.h>
+
+#include "host.h"
+
+
+/**
+ * @brief The state of one emulated KS0108 controller.
+*/
+typedef struct
+{
+    u8   ram[KS0108_PAGES][KS0108_COLUMNS];
+    u8   page;
+    u8   column;
+    u8   start_line;
+    u8   output;        // Loaded by each read, returned by the next.
+    bool on;
+} Controller;
+
+// The left and right halves of the panel.
+static Controller chips[2];
+
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+/**
+ * @brief A reset leaves the display off. The RAM is filled with a pattern, as
+ *        its contents are undefined on the real controller.
+ */
+void ks0108_init(void)
+{
+    for (int c = 0; c < 2; c++)
+    {
+        for (int p = 0; p < KS0108_PAGES; p++)
+            for (int x = 0; x < KS0108_COLUMNS; x++)
+                chips[c].ram[p][x] = 0x55;
+
+        chips[c].page       = 0;
+        chips[c].column     = 0;
+        chips[c].start_line = 0;
+        chips[c].output     = 0;
+        chips[c].on         = false;
+    }
+}
+
+
+void ks0108_command(u8 mask, u8 cmd)
+{
+    host_stats.display_command++;
+
+    for (int c = 0; c < 2; c++)
+    {
+        if (!(mask & (1 << c)))
+            continue;
+
+        if ((cmd & 0xFE) == KS0108_DISPLAY_OFF)
+            chips[c].on = cmd & 1;
+        else if ((cmd & 0xC0) == KS0108_SET_ADDRESS)
+            chips[c].column = cmd & 0x3F;
+        else if ((cmd & 0xF8) == KS0108_SET_PAGE)
+            chips[c].page = cmd & 0x07;
+        else if ((cmd & 0xC0) == KS0108_START_LINE)
+            chips[c].start_line = cmd & 0x3F;
+    }
+}
+
+
+void ks0108_write(u8 mask, u8 data)
+{
+    host_stats.display_data++;
+
+    for (int c = 0; c < 2; c++)
+    {
+        if (!(mask & (1 << c)))
+            continue;
+
+        chips[c].ram[chips[c].page][chips[c].column] = data;
+        chips[c].column = (chips[c].column + 1) % KS0108_COLUMNS;
+    }
+}
+
+
+u8 ks0108_read(u8 mask)
+{
+    host_stats.display_read++;
+
+    Controller *c = &chips[mask == KS0108_RIGHT];
+    u8 data = c->output;
+
+    c->output = c->ram[c->page][c->column];
+    c->column = (c->column + 1) % KS0108_COLUMNS;
+
+    return data;
+}
+
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+void host_display_dump(void)
+{
+    for (int y = 0; y < 8 * KS0108_PAGES; y++)
+    {
+        for (int x = 0; x < 2 * KS0108_COLUMNS; x++)
+        {
+            Controller *c    = &chips[x / KS0108_COLUMNS];
+            int         line = (y + c->start_line) % (8 * KS0108_PAGES);
+            u8          byte = c->ram[line >> 3][x % KS0108_COLUMNS];
+
+            putchar(c->on && (byte >> (line & 7)) & 1 ? '#' : '.');
+        }
+        putchar('\n');
+    }
+}
@@ -0,0 +1,106 @@
+#include "timer.h"
+
+#include "host.h"
+#include "cycles.h"
+
+
+static void (*timer_handler)(void) = NULL;
+
+static u64  period_ns    = 0;
+static u64  next_ns      = 0;
+static bool in_interrupt = false;
+
+static void (*soft_handler)(void) = NULL;
+static bool soft_pending = false;
+static bool in_soft_irq  = false;
+
+
+void timer_start(u32 hz, void (*handler)(void))
+{
+    timer_handler = handler;
+    period_ns     = 1000000000ull / hz;
+    next_ns       = host_time_ns + period_ns;
+}
+
+
+void soft_irq_attach(void (*handler)(void))
+{
+    soft_handler = handler;
+}
+
+
+/**
+ * @brief Run the software interrupt if it is pending. The timer interrupt can
+ *        still run inside it, as it has the higher priority.
+ */
+static void run_soft_irq(void)
+{
+    if (!soft_handler || in_soft_irq)
+        return;
+
+    in_soft_irq = true;
+
+    while (soft_pending)
+    {
+        soft_pending = false;
+        soft_handler();
+    }
+
+    in_soft_irq = false;
+}
+
+
+void soft_irq_raise(void)
+{
+    soft_pending = true;
+
+    if (!in_interrupt)
+        run_soft_irq();
+}
+
+
+/**
+ * @brief Advance the virtual clock to the next timer interrupt.
+ */
+void wait_for_interrupt(void)
+{
+    if (!timer_handler)
+        return;
+
+    host_advance(next_ns > host_time_ns ? next_ns - host_time_ns : 0);
+}
+
+
+/**
+ * @brief The host never sleeps, it only advances the virtual clock. Its cycles
+ *        are real nanoseconds, so this is how long the game has taken to run,
+ *        and the load is that against virtual time.
+ */
+u32 busy_cycles(void)
+{
+    return cycles_now();
+}
+
+
+/**
+ * @brief Run the handler once for every period the virtual clock has passed.
+ *        Time spent inside the handler doesn't trigger nested interrupts.
+ */
+void host_timer_update(void)
+{
+    if (!timer_handler || in_interrupt)
+        return;
+
+    in_interrupt = true;
+
+    while (host_time_ns >= next_ns)
+    {
+        next_ns += period_ns;
+        timer_handler();
+    }
+
+    in_interrupt = false;
+
+    // Requested by the timer interrupt, so it runs once that has returned.
+    run_soft_irq();
+}
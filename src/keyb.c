@@ -1,6 +1,6 @@
 #include "keyb.h"
 
-#include "memreg.h"
+#include "ticker.h"
 
 
 static Input input =
@@ -45,33 +45,9 @@ Input *keyb(void)
 }
 
 
-void activate_row(u32 row)
-{
-    volatile gpio_t *gpiod = (gpio_t*)GPIOD;
-
-    switch (row)
-    {
-    case 1:
-        gpiod->ODR_HIGH = 0x10; break;
-
-    case 2:
-        gpiod->ODR_HIGH = 0x20; break;
-
-    case 3:
-        gpiod->ODR_HIGH = 0x40; break;
-
-    case 4:
-        gpiod->ODR_HIGH = 0x80; break;
-
-    default: break;
-        // NAUGHTY MOVE
-    }
-}
-
 void buffered_read_column(void)
 {
-    volatile gpio_t *gpiod = (gpio_t*)GPIOD;
-    u8 c = gpiod->IDR_HIGH;
+    u8 c = read_columns();
 
     if ( c & 0b1000 )
         col_buffer[col_count++] = 4;
@@ -93,4 +69,118 @@ u8 key_value(u32 row, u32 col)
     col--;
 
     return KEYCODE[row][col];
-}
\ No newline at end of file
+}
+
+// =============================================================================
+//                           BACKGROUND SAMPLING
+
+// Written by the interrupt only.
+static volatile u16 held     = 0;
+static u8           stable[KEYB_KEYS];
+static volatile u32 dropped  = 0;
+
+// The event queue. `head` is only written by the interrupt and `tail` only by
+// the game, so no locking is needed.
+static KeyEvent     queue[KEYB_QUEUE_SIZE];
+static volatile u32 head = 0;
+static volatile u32 tail = 0;
+
+
+u16 keyb_scan(void)
+{
+    u16 keys = 0;
+
+    for (u32 row = 1; row <= 4; row++)
+    {
+        activate_row(row);
+        u8 c = read_columns();
+
+        for (u32 col = 1; col <= 4; col++)
+            if (c & (1 << (col - 1)))
+                keys |= 1 << key_value(row, col);
+    }
+
+    return keys;
+}
+
+
+void keyb_init(void)
+{
+    ticker_attach(keyb_sample);
+}
+
+
+/**
+ * @brief Push an event to the queue, or count it as dropped if it is full.
+ */
+static void push_event(u8 key, bool pressed)
+{
+    u32 next = (head + 1) % KEYB_QUEUE_SIZE;
+
+    if (next == tail)
+    {
+        dropped++;
+        return;
+    }
+
+    queue[head] = (KeyEvent){ ticker_millis(), key, pressed };
+    head = next;
+}
+
+
+void keyb_sample(void)
+{
+    u16 raw  = keyb_scan();
+    u16 keys = held;
+
+    for (u8 key = 0; key < KEYB_KEYS; key++)
+    {
+        bool is_down  = (raw  >> key) & 1;
+        bool was_down = (keys >> key) & 1;
+
+        if (is_down == was_down)
+        {
+            stable[key] = 0;
+            continue;
+        }
+
+        if (++stable[key] < KEYB_DEBOUNCE)
+            continue;
+
+        stable[key] = 0;
+        keys ^= 1 << key;
+        push_event(key, is_down);
+    }
+
+    held = keys;
+}
+
+
+u16 keyb_held(void)
+{
+    return held;
+}
+
+
+bool keyb_next_event(KeyEvent *event)
+{
+    if (tail == head)
+        return false;
+
+    *event = queue[tail];
+    tail = (tail + 1) % KEYB_QUEUE_SIZE;
+
+    return true;
+}
+
+
+void keyb_clear_events(void)
+{
+    tail = head;
+}
+
+
+u32 keyb_dropped_events(void)
+{
+    return dropped;
+}
@@ -3,284 +3,139 @@
 //                         INCLUDES & PRE-PROCESSOR
 
 #include "typedef.h"
-#include "memreg.h"
-#include "delay.h"
+#include "hal.h"
 #include "display_driver.h"
+#include "framebuffer.h"
+#include "render_queue.h"
+#include "font.h"
 #include "graphics.h"
+#include "physics.h"
+#include "entity.h"
+#include "match.h"
+#include "cpu_paddle.h"
+#include "ticker.h"
+#include "sched.h"
+#include "profile.h"
+#include "replay.h"
 #include "keyb.h"
 #include "ascii_game.h"
+#include "ascii_buffer.h"
 #include "ascii.h"
+#include "ascii_queue.h"
 
 // =============================================================================
-//                                REGISTERS
+//                                 CONSTANTS
 
-static gpio_t    *gpiod   = (gpio_t*)   GPIOD;   // GPIOD register
-static gpio_t    *gpioe   = (gpio_t*)   GPIOE;   // GPIOE register
-static systick_t *systick = (systick_t*)SYSTICK; // SysTick register
+// The keys that start a match in each mode.
+#define START_CPU        4
+#define START_CLASSIC    5
+#define START_MULTIBALL  6
 
+// Where the scores are drawn: either side of the middle, at the top.
+#define SCORE_Y    3
+#define SCORE_GAP  8
 
-// =============================================================================
-//                                  SET-UP
-
-void app_init(void)
-{
-    // Start clocks for port D and port E.
-    *(ulong*)0x40023830 = 0x18;
-    // Starta clocks for SYSCFG
-    *(ulong*)0x40023844 |= 0x4000;
+// How the computer plays the right paddle when started with START_CPU. It
+// reacts after about 130 ms. The ball misses the paddle once the aim is off
+// by more than half of both their heights, 6.5 pixels, so with an error of up
+// to 9 about a third of its aims miss and it can be beaten.
+#define CPU_REACTION_FRAMES 8
+#define CPU_ERROR_PX        9
 
-    gpiod->MODER_LOW  =     0x5555;
-    gpiod->MODER_HIGH =     0x5500;
-    gpiod->OSPEEDR    = 0x55555555;
-    gpiod->OTYPER    &=     0x00FF;
-    gpiod->PUPDR     &= 0x0000FFFF;
-    gpiod->PUPDR     |= 0x00AA0000;
-
-
-    gpioe->MODER   = 0x00005555;
-    gpioe->OSPEEDR = 0x55555555;
-}
+// How long the winner is shown before the start screen comes back.
+#define GAME_OVER_MS 5000
 
 
 // =============================================================================
 //                                 FUNCTIONS
 
-void wait_for_start_press()
-{
-    bool start = false;
-    while (true)
-    {
-        Input *keyb_input = keyb();
-
-        for (u8 i = 0; i < keyb_input->n_presses; i++)
-        {
-            u8 current_input = keyb_input->buffer[i];
-            switch (current_input)
-            {
-            case 5:
-                start = true;
-            default:
-                break; // To handle any eventual behaviour.
-            }
-        }
-
-        if (start) break;
-    }
-}
-
-/**
-* @brief Checks if the ball collides with the paddle.
-*
-* @param ball   The ball to detect a collision with.
-* @param paddle The Paddle to detect a collision with.
-*/
-bool colliding_with_paddle(P_Object ball, P_Object paddle)
-{
-    i8 ball_min_x = ball->pos_x;
-    i8 ball_max_x = ball->pos_x + ball->geo->size_x;
-    i8 ball_min_y = ball->pos_y;
-    i8 ball_max_y = ball->pos_y + ball->geo->size_y;
-
-    i8 paddle_min_x = paddle->pos_x;
-    i8 paddle_max_x = paddle->pos_x + paddle->geo->size_x;
-    i8 paddle_min_y = paddle->pos_y;
-    i8 paddle_max_y = paddle->pos_y + paddle->geo->size_y;
-
-    return
-        ball_min_x <= paddle_max_x
-        &&
-        ball_max_x >= paddle_min_x
-        &&
-        ball_min_y <= paddle_max_y
-        &&
-        ball_max_y >= paddle_min_y;
-}
-
-/**
-* @brief Checks if the ball collides with one of the paddles.
-*
-* @param ball     The ball to detect a collision with.
-* @param l_paddle The left paddle to detect a collision with.
-* @param r_paddle The right paddle to detect a collision with.
-*/
-bool colliding_with_paddles(P_Object ball, P_Object l_paddle, P_Object r_paddle)
-{
-    bool left_collision = colliding_with_paddle(ball, l_paddle);
-    bool right_collision = colliding_with_paddle(ball, r_paddle);
-    return left_collision || right_collision;
-}
-
 /**
 * @brief Moves an object one "tick" by updating its coordinates with its speed.
+*        Nothing is drawn, see render().
 *
 * @param object The object to be moved
 */
 void move_object(P_Object object)
 {
-    // Clear the ball temporarily from the screen
-    object->clear(object);
-
-    // Update the position of the ball
     object->pos_x += object->dir_x;
     object->pos_y += object->dir_y;
-
-    // Draw the ball with its new positions
-    draw_object(object);
 }
 
 /**
 * @brief Sets the speed of the given object
 *
 * @param object The object to set the speed for
-* @param speed_x The speed in horizontal direction
-* @param speed_y The speed in vertical direction
+* @param speed_x The speed in horizontal direction, in pixels per tick
+* @param speed_y The speed in vertical direction, in pixels per tick
 */
-void set_object_speed(P_Object object, int speed_x, int speed_y)
+void set_object_speed(P_Object object, fixed speed_x, fixed speed_y)
 {
     object->dir_x = speed_x;
     object->dir_y = speed_y;
 }
 
-/**
-* @brief Checks if the ball collides with a wall. Returns information about
-*        the possible collision in the form of a WallCollision struct.
-*
-* @param ball The ball to check collision with the walls.
-*/
-WallCollision check_wall_collision(P_Object ball)
-{
-    i16 ball_min_x = ball->pos_x;
-    i16 ball_max_x = ball->pos_x + ball->geo->size_x;
-    i16 ball_min_y = ball->pos_y;
-    i16 ball_max_y = ball->pos_y + ball->geo->size_y;
-    WallCollision result;
-
-    // Check left wall collision
-    if (ball_min_x < 1) {
-        result = (WallCollision) { .is_colliding = true, .which = 'l'};
-        return result;
-    }
-    // Check right wall collision
-    if (ball_max_x > 128) {
-        result = (WallCollision) { .is_colliding = true, .which = 'r'};
-        return result;
-    }
-    // Check upper wall collision
-    if (ball_min_y < 1) {
-        result = (WallCollision) { .is_colliding = true, .which = 'u'};
-        return result;
-    }
-    // Check lower wall collision
-    if (ball_max_y > 64) {
-        result = (WallCollision) { .is_colliding = true, .which = 'd'};
-        return result;
-    }
-    // When no wall collision occurs
-    result = (WallCollision){ false };
-    return result;
-}
-
-/**
-* @brief Resets the ball and the paddle to their initial positions
-*
-* @param ball         The ball to reset
-* @param left_paddle  The left paddle to reset
-* @param right_paddle The right paddle to reset
-*/
-void reset_game_objects(
-    P_Object ball,
-    P_Object left_paddle,
-    P_Object right_paddle
-)
-{
-    // Reset ball
-    ball->dir_x =  5;
-    ball->dir_y =  0;
-    ball->pos_x = 62;
-    ball->pos_y = 30;
-
-    // Reset paddles
-    left_paddle->dir_x =  0;
-    left_paddle->dir_y =  0;
-    left_paddle->pos_x = 10;
-    left_paddle->pos_y = 30;
-
-    right_paddle->dir_x =   0;
-    right_paddle->dir_y =   0;
-    right_paddle->pos_x = 110;
-    right_paddle->pos_y =  30;
-}
-
-
-void game_over(P_Player p)
-{
-    ascii_player_wins(p);
-    delay_milli(5000);
-}
-
 
 // =============================================================================
 //                       GLOBAL VARIABLES AND CONSTANTS
 
-Geometry ball_geometry =
+static const u32 ball_pixels[] =
 {
-    12,     // numpoints
-    4,      // size_x
-    4,      // size_y
-    {
-        {0,1},{0,2},{1,0},{1,1},{1,2},{1,3},{2,0},{2,1},{2,2},{2,3},{3,1},{3,2}
-    }
+    0b0110,
+    0b1111,
+    0b1111,
+    0b0110
 };
 
+static Sprite ball_sprite = SPRITE(ball_pixels);
 
-static Object ball =
-{
-    &ball_geometry,
-    0,0,            // Initial direction
-    1,1,            // Initial startposition
-    draw_object,
-    clear_object,
-    move_object,
-    set_object_speed
-};
+// The id of the ball's sprite in the entity store. The balls themselves are
+// entities.
+static u8 ball_sprite_id;
 
 
-Geometry paddle_geometry =
+static const u32 paddle_pixels[] =
 {
-    31, // numpoints
-    5,  // size_x
-    8,  // size_y
-    {
-        {0,0},{1,0},{2,0},{3,0},{4,0},                         // Upper wall
-        {0,0},{0,1},{0,2},{0,3},{0,4},{0,5},{0,6},{0,7},{0,8}, // Left wall
-        {4,0},{4,1},{4,2},{4,3},{4,4},{4,5},{4,6},{4,7},{4,8}, // Right wall
-        {0,8},{1,8},{2,8},{3,8},{4,8},                         // Lower wall
-        {2,3},{2,4},{2,5}                                      // Middle section
-    }
+    0b11111,    // Upper wall
+    0b10001,    // Left and right walls
+    0b10001,
+    0b10101,    // Middle section
+    0b10101,
+    0b10101,
+    0b10001,
+    0b10001,
+    0b11111     // Lower wall
 };
 
+static Sprite paddle_sprite = SPRITE(paddle_pixels);
+
 
 static Object right_paddle =
 {
-    &paddle_geometry,
+    &paddle_sprite,
     0,0,                // Initial direction
-    110,50,             // Start position
+    INT_TO_FX(110),     // Start position
+    INT_TO_FX(50),
     draw_object,
     clear_object,
     move_object,
-    set_object_speed
+    set_object_speed,
+    0,0,                // Previous position, set by match_new_round()
+    0,0                 // Drawn position, set when drawn
 };
 
 
 static Object left_paddle =
 {
-    &paddle_geometry,
+    &paddle_sprite,
     0,0,                // Initial direction
-    10,50,              // Start position
+    INT_TO_FX(10),      // Start position
+    INT_TO_FX(50),
     draw_object,
     clear_object,
     move_object,
-    set_object_speed
+    set_object_speed,
+    0,0,                // Previous position, set by match_new_round()
+    0,0                 // Drawn position, set when drawn
 };
 
 
@@ -303,137 +158,396 @@ static Player player_2 =
 
 
 // =============================================================================
-//                                 MAIN
+//                                 FRAMES
 
 #define PLAYER1_UP  1
 #define PLAYER1_DW  7
 #define PLAYER2_UP  3
 #define PLAYER2_DW  9
-#define SPEED       2
 
 
-int main(void)
+/**
+* @brief Waits for the next tick of the game clock and reads the keypad. When
+*        replaying, both come from the log instead, without waiting.
+*
+* @param keys Set to the keys held, as a bitmask indexed by key value
+* @return The number of logic ticks to run this frame
+*/
+static u32 next_frame(u16 *keys)
 {
-    // Initialize application
-    app_init();
-    graphic_initialize();
-    ascii_init();
+    u32 steps;
+
+    if (replay_active())
+    {
+        if (!replay_next(&steps, keys))
+            app_finish();
+        return steps;
+    }
 
-    // Initializing the ball and the players
+    steps = ticker_wait();
 
-init_game:
-    graphic_clear_screen();
-    ascii_start_screen();
-    wait_for_start_press();
-    // Game reset
-new_round:
-    graphic_clear_screen();
-    reset_game_objects(&ball, &left_paddle, &right_paddle);
-
-    // Gameplay-loop
-    while (true)
+    // The keypad is sampled in the background, so only the debounced state
+    // is needed here.
+    *keys = keyb_held();
+    keyb_clear_events();
+
+    replay_record(steps, *keys);
+    return steps;
+}
+
+
+// The phase render() last drew at, so it isn't drawn again until it changes.
+static fixed drawn_alpha;
+
+
+/**
+* @brief Draws the points of a player, the digits written over what was there.
+*        The result is the same each time, so redrawing it every frame only
+*        costs a few word writes and nothing is sent to the display.
+*
+* @param right_align Whether x is the right edge of the text rather than the left
+*/
+static void draw_points(u32 points, int x, bool right_align)
+{
+    char text[11];
+    int  n = sizeof text - 1;
+
+    text[n] = '\0';
+    do
     {
-        ascii_init_game(&player_1, &player_2);
-        ascii_draw_score(&player_1);
-	    ascii_draw_score(&player_2);
+        text[--n] = '0' + points % 10;
+        points /= 10;
+    } while (points > 0);
 
-        // Read general input
-        Input *keyb_input = keyb();
-        i8 player_1_dy = 0;
-        i8 player_2_dy = 0;
+    if (right_align)
+        x -= font_text_width(&font_digits, &text[n]) - 1;
 
-        const u8 MAX_SCORE = 3;
+    font_draw(&font_digits, &text[n], x, SCORE_Y);
+}
 
-        if (keyb_input->n_presses > 0)
-        {
-            for (u8 i = 0; i < keyb_input->n_presses; i++)
-            {
-                u8 current_input = keyb_input->buffer[i];
-                switch (current_input)
-                {
-                case PLAYER1_UP:
-                    player_1_dy--; break;
-                case PLAYER1_DW:
-                    player_1_dy++; break;
-                case PLAYER2_UP:
-                    player_2_dy--; break;
-                case PLAYER2_DW:
-                    player_2_dy++; break;
-                default:
-                    break; // To handle any eventual behaviour.
-                }
-            }
 
-        }
+/**
+* @brief Draws the balls and the paddles a fraction of the way from where they
+*        were before the last tick to where they are now, and sends the
+*        changes to the render queue. Only pixels that end up different are
+*        sent, so drawing more often than the game logic runs is cheap, and
+*        they are sent from an interrupt while the game goes on.
+*
+* @param alpha How far between the two positions, from 0 to FX_ONE
+*/
+static void render(fixed alpha)
+{
+    drawn_alpha = alpha;
+
+    // The balls are erased first and drawn last, so they can't erase pixels
+    // of each other, of the paddles or of the scores. The balls fly over the
+    // scores, which are drawn again in between.
+    entity_erase_all();
+    draw_points(player_1.points, FB_WIDTH / 2 - SCORE_GAP / 2, true);
+    draw_points(player_2.points, FB_WIDTH / 2 + SCORE_GAP / 2 + 1, false);
+    draw_object_between(&left_paddle,  alpha);
+    draw_object_between(&right_paddle, alpha);
+    entity_draw_all(alpha);
+
+    fb_flush();
+}
 
-        // Set the speed of the paddles from the input of the keypad
-        left_paddle.set_speed(&left_paddle,  0, player_1_dy * SPEED);
-        right_paddle.set_speed(&right_paddle, 0, player_2_dy * SPEED);
 
-        // Only move the paddles if they are inside of the screen
-        if (3 < left_paddle.pos_y && left_paddle.pos_y < 53)
-            left_paddle.move(&left_paddle);
-        if (3 < right_paddle.pos_y && right_paddle.pos_y < 53)
-            right_paddle.move(&right_paddle);
+/**
+* @brief Returns a checksum of everything that the input can affect.
+*/
+static u32 game_state_hash(void)
+{
+    u32 hash = REPLAY_HASH_INIT;
 
+    hash = replay_hash(hash, entities.count);
+    for (int i = 0; i < entities.count; i++)
+    {
+        hash = replay_hash(hash, entities.pos_x[i]);
+        hash = replay_hash(hash, entities.pos_y[i]);
+        hash = replay_hash(hash, entities.dir_x[i]);
+        hash = replay_hash(hash, entities.dir_y[i]);
+    }
+    hash = replay_hash(hash, left_paddle.pos_y);
+    hash = replay_hash(hash, right_paddle.pos_y);
+    hash = replay_hash(hash, player_1.points);
+    hash = replay_hash(hash, player_2.points);
 
-        // Move ball
-        ball.move(&ball);
+    return hash;
+}
 
-        //Collision-detection of ball with paddles
-        if (colliding_with_paddles(&ball, &left_paddle, &right_paddle))
-            ball.dir_x *= -1;
 
+// =============================================================================
+//                                GAME STATES
 
-        // Checks for ball collision with walls.
-        // Updates the game accordingly with the different wall collisions
-        WallCollision wc = check_wall_collision(&ball);
-        bool player_scored = false;
-        if (wc.is_colliding)
-        {
-            switch (wc.which)
-            {
-                // Ball hit upper wall
-                case 'u':
-                    ball.dir_y *= -1;
-                    break;
-
-                // Ball hit lower wall
-                case 'd':
-                    ball.dir_y *= -1;
-                    break;
-
-                // Ball hit left wall
-                case 'l':
-                    player_2.points += 1;
-                    player_scored = true;
-                    break;
-
-                // Ball hit right wall
-                case 'r':
-                    player_1.points += 1;
-                    player_scored = true;
-                    break;
-
-                // This shouldn't be reached
-                default:
-                    break;
-            }
-        }
+/**
+* @brief What the game is doing. Each state enables the tasks it needs, and
+*        moves to the next state from a task or a timer, never by waiting.
+*/
+typedef enum
+{
+    GAME_START_SCREEN,  // Waiting for a start key.
+    GAME_PLAYING,       // A match is on.
+    GAME_OVER           // Showing the winner, until `game_over_timer` fires.
+} GameState;
+
+static SoftTimer game_over_timer;
+
+static Match     match;
+static bool      vs_cpu;
+static CpuPaddle cpu;
+
+
+static void menu_run(void);
+static void frame_run(void);
+static bool frame_ready(void);
+static void render_run(void);
+static bool render_ready(void);
+static void telemetry_run(void);
+
+// In priority order. Between ticks, drawing takes whatever time is left.
+static Task menu_task      = TASK("menu",      menu_run,      NULL,         1);
+static Task frame_task     = TASK("frame",     frame_run,     frame_ready,  0);
+static Task render_task    = TASK("render",    render_run,    render_ready, 0);
+static Task telemetry_task = TASK("telemetry", telemetry_run, NULL,         PROF_REPORT_MS);
+
+
+/**
+* @brief Enables the tasks of a state and disables the others.
+*/
+static void enter_state(GameState state)
+{
+    sched_enable(&menu_task,   state == GAME_START_SCREEN);
+    sched_enable(&frame_task,  state == GAME_PLAYING);
+    sched_enable(&render_task, state == GAME_PLAYING);
+}
+
+
+/**
+* @brief Puts the ball and the paddles back in place and starts the round at
+*        the next tick.
+*/
+static void new_round(void)
+{
+    fb_clear();
+    match_new_round(&match);
+    cpu_paddle_init(
+        &cpu, &right_paddle, CPU_REACTION_FRAMES, CPU_ERROR_PX,
+        1 + player_1.points + (player_2.points << 8)
+    );
+    entity_draw_all(FX_ONE);
+    left_paddle.draw(&left_paddle);
+    right_paddle.draw(&right_paddle);
+    ticker_sync();
+}
+
+
+/**
+* @brief Starts a match in the mode of the start key that was pressed.
+*/
+static void start_match(u8 key)
+{
+    GameMode mode = key == START_MULTIBALL ? MODE_MULTIBALL : MODE_CLASSIC;
+    vs_cpu = key == START_CPU;
+
+    const MatchRules rules = MATCH_RULES(mode);
+    match_init(&match, &rules, &player_1, &player_2, ball_sprite_id);
+    ascii_init_game(&player_1, &player_2);
+    new_round();
 
-        if (player_1.points >= MAX_SCORE || player_2.points >= MAX_SCORE)
+    enter_state(GAME_PLAYING);
+}
+
+
+/**
+* @brief Shows the start screen and waits for a start key. Presses made before
+*        are ignored. A replay starts each match at once, in the mode that was
+*        recorded, and ends the run when there are no more.
+*/
+static void show_start_screen(void)
+{
+    fb_clear();
+    ascii_start_screen();
+    keyb_clear_events();
+    enter_state(GAME_START_SCREEN);
+
+    if (replay_active())
+    {
+        u8 key;
+
+        if (!replay_start(&key))
+            app_finish();
+        start_match(key);
+    }
+}
+
+
+/**
+* @brief Shows the winner, then goes back to the start screen once
+*        GAME_OVER_MS has passed. A replay goes back at once.
+*/
+static void game_over(P_Player p)
+{
+    enter_state(GAME_OVER);
+    ascii_player_wins(p);
+    replay_flush();
+
+    if (replay_active())
+        show_start_screen();
+    else
+        sched_timer_start(&game_over_timer, GAME_OVER_MS, show_start_screen);
+}
+
+
+// =============================================================================
+//                                  TASKS
+
+/**
+* @brief Starts a match when one of the start keys is pressed.
+*/
+static void menu_run(void)
+{
+    KeyEvent event;
+
+    while (keyb_next_event(&event))
+    {
+        if (!event.pressed)
+            continue;
+
+        if (event.key == START_CPU
+            || event.key == START_CLASSIC
+            || event.key == START_MULTIBALL)
         {
-            if (player_1.points >= MAX_SCORE)
-                game_over(&player_1);
-            else if (player_2.points >= MAX_SCORE)
-                game_over(&player_2);
-            player_1.points = 0;
-            player_2.points = 0;
-            goto init_game;
+            replay_record_start(event.key);
+            start_match(event.key);
+            return;
         }
-        else if (player_scored)
-            goto new_round;
     }
-    
+}
+
+
+/**
+* @brief A replay doesn't wait for the ticker, so there is always a frame.
+*/
+static bool frame_ready(void)
+{
+    return replay_active() || ticker_pending();
+}
+
+
+/**
+* @brief Reads the keys, moves everything on by the ticks that have passed and
+*        draws the result.
+*/
+static void frame_run(void)
+{
+    u16 keys;
+    u32 steps = next_frame(&keys);
+    profile_frame_start();
+
+    // Map the keys to the movement of the paddles.
+    i8 player_1_dy = 0;
+    i8 player_2_dy = 0;
+
+    if (keys & (1 << PLAYER1_UP)) player_1_dy--;
+    if (keys & (1 << PLAYER1_DW)) player_1_dy++;
+    if (keys & (1 << PLAYER2_UP)) player_2_dy--;
+    if (keys & (1 << PLAYER2_DW)) player_2_dy++;
+
+    // The computer takes the place of player 2.
+    if (vs_cpu)
+        player_2_dy = cpu_paddle_update(&cpu);
+    profile_lap(PROF_INPUT);
+
+    // Balls that score are removed by match_frame(), which leaves them on the
+    // screen, so the balls are erased while they are all still in the store.
+    // render() erases the rest again, which changes nothing.
+    entity_erase_all();
+
+    MatchState state = match_frame(&match, player_1_dy, player_2_dy, steps);
+    profile_lap(PROF_PHYSICS);
+
+    replay_end_frame(game_state_hash());
+
+    // A replay doesn't wait for the ticker, so it shows each tick as it is.
+    render(replay_active() ? FX_ONE : ticker_phase());
+    profile_lap(PROF_RENDER);
+    profile_frame_end();
+
+    if (state == MATCH_OVER)
+        game_over(match_winner(&match));
+    else if (state == MATCH_ROUND_OVER)
+        new_round();
+}
+
+
+/**
+* @brief Draws between the last two ticks whenever the ticker has moved on,
+*        as long as the display keeps up. Drawing before the last frame is out
+*        would only wait for it.
+*/
+static bool render_ready(void)
+{
+    return !replay_active()
+        && !render_queue_busy()
+        && ticker_phase() != drawn_alpha;
+}
+
+
+/**
+* @brief The phase is read before checking for a tick, so it can't have
+*        wrapped around.
+*/
+static void render_run(void)
+{
+    fixed alpha = ticker_phase();
+    if (ticker_pending())
+        return;
+
+    render(alpha);
+}
+
+
+/**
+* @brief Reports the run times of the frame stages and of the tasks over the
+*        serial port.
+*/
+static void telemetry_run(void)
+{
+    profile_report();
+    sched_report();
+}
+
+
+// =============================================================================
+//                                 MAIN
+
+int main(void)
+{
+    // Initialize application
+    app_init();
+    profile_init();
+    graphic_initialize();
+    ascii_init();
+    ascii_buf_init();
+    ticker_init(TICK_HZ);
+    keyb_init();
+    ascii_queue_init();
+    render_queue_init();
+    sched_init();
+    sprite_init(&ball_sprite);
+    sprite_init(&paddle_sprite);
+
+    ball_sprite_id = entity_add_sprite(&ball_sprite);
+
+    sched_add(&menu_task);
+    sched_add(&frame_task);
+    sched_add(&render_task);
+    sched_add(&telemetry_task);
+    sched_enable(&telemetry_task, true);
+
+    show_start_screen();
+    sched_run();
+
     return 0;
-}
\ No newline at end of file
+}
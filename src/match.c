@@ -0,0 +1,156 @@
+#include "match.h"
+
+// =============================================================================
+//                         INCLUDES & PRE-PROCESSOR
+
+#include "entity.h"
+#include "fixed.h"
+#include "graphics.h"
+#include "physics.h"
+#include "typedef.h"
+
+
+// How far up and down the paddles can go.
+#define PADDLE_MIN_Y INT_TO_FX(3)
+#define PADDLE_MAX_Y INT_TO_FX(53)
+
+
+// =============================================================================
+//                                GLOBAL DATA
+
+// The outcome of the last tick for each ball. Too big for the stack.
+static THREAD_LOCAL BallStep outcomes[ENTITY_MAX];
+
+
+// =============================================================================
+//                                 FUNCTIONS
+
+/**
+ * @brief Move a paddle one tick, stopping it at the top and bottom of the
+ *        screen. It can always move away again.
+ */
+static void move_paddle(P_Object paddle)
+{
+    paddle->move(paddle);
+
+    if (paddle->pos_y < PADDLE_MIN_Y) paddle->pos_y = PADDLE_MIN_Y;
+    if (paddle->pos_y > PADDLE_MAX_Y) paddle->pos_y = PADDLE_MAX_Y;
+}
+
+
+void match_init(P_Match match, const MatchRules *rules, P_Player left, P_Player right, u8 ball_sprite)
+{
+    match->rules       = *rules;
+    match->left        = left;
+    match->right       = right;
+    match->ball_sprite = ball_sprite;
+    match->rally       = 0;
+
+    left->points  = 0;
+    right->points = 0;
+}
+
+
+void match_new_round(P_Match match)
+{
+    P_Object left  = match->left->paddle;
+    P_Object right = match->right->paddle;
+
+    // Reset ball
+    entity_clear();
+    entity_spawn(match->ball_sprite, INT_TO_FX(62), INT_TO_FX(30), match->rules.ball_speed, 0);
+
+    // Reset paddles
+    left->dir_x =  0;
+    left->dir_y =  0;
+    left->pos_x = INT_TO_FX(10);
+    left->pos_y = INT_TO_FX(30);
+
+    right->dir_x =   0;
+    right->dir_y =   0;
+    right->pos_x = INT_TO_FX(110);
+    right->pos_y = INT_TO_FX(30);
+
+    left->prev_x  = left->pos_x;
+    left->prev_y  = left->pos_y;
+    right->prev_x = right->pos_x;
+    right->prev_y = right->pos_y;
+
+    match->rally = 0;
+}
+
+
+MatchState match_frame(P_Match match, i8 left_dy, i8 right_dy, u32 steps)
+{
+    P_Object left  = match->left->paddle;
+    P_Object right = match->right->paddle;
+
+    // Set the speed of the paddles from the input
+    left->set_speed(left,   0, left_dy  * match->rules.paddle_speed);
+    right->set_speed(right, 0, right_dy * match->rules.paddle_speed);
+
+    // Run one simulation step per tick that has passed since last frame.
+    for (u32 step = steps; step > 0 && entities.count > 0; step--)
+    {
+        left->prev_x  = left->pos_x;
+        left->prev_y  = left->pos_y;
+        right->prev_x = right->pos_x;
+        right->prev_y = right->pos_y;
+
+        move_paddle(left);
+        move_paddle(right);
+
+        // Move all balls
+        entities_step(left, right, match->rules.ball_speed, outcomes);
+
+        // Act on the outcomes from the last ball down, so removing a ball
+        // only moves one that has been handled into its place.
+        for (int i = entities.count - 1; i >= 0; i--)
+        {
+            match->rally += outcomes[i].paddle_hits;
+
+            // Update the score if the ball left the field
+            switch (outcomes[i].scored)
+            {
+                // Ball hit left wall
+                case 'l':
+                    match->right->points += 1;
+                    entity_remove(i);
+                    continue;
+
+                // Ball hit right wall
+                case 'r':
+                    match->left->points += 1;
+                    entity_remove(i);
+                    continue;
+
+                default:
+                    break;
+            }
+
+            // A paddle hit splits the ball in two, mirrored vertically.
+            if (match->rules.mode == MODE_MULTIBALL && outcomes[i].paddle_hits > 0)
+                entity_spawn(
+                    match->ball_sprite,
+                    entities.pos_x[i], entities.pos_y[i],
+                    entities.dir_x[i], -entities.dir_y[i]
+                );
+        }
+    }
+
+    if (match_winner(match))
+        return MATCH_OVER;
+    if (entities.count == 0)
+        return MATCH_ROUND_OVER;
+    return MATCH_PLAYING;
+}
+
+
+P_Player match_winner(P_Match match)
+{
+    if (match->left->points >= match->rules.max_score)
+        return match->left;
+    if (match->right->points >= match->rules.max_score)
+        return match->right;
+    return NULL;
+}
@@ -22,6 +22,14 @@ extern void delay_mikro(u32);
 extern void delay_milli(u32);
 
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+void ascii_ctrl_bit_set(u8 x);
+void ascii_ctrl_bit_clear(u8 x);
+void ascii_write_controller(u8 byte);
+u8   ascii_read_controller();
+
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
 /**
@@ -165,6 +173,16 @@ u8 ascii_read_data(void)
 }
 
 
+/**
+ * @brief Return whether the controller is still executing an instruction.
+ *        Takes a single read of the status register.
+ */
+bool ascii_busy(void)
+{
+    return (ascii_read_status() & 0x80) == 0x80;
+}
+
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
 /**
@@ -182,7 +200,7 @@ void ascii_command(
     u32  delay_dur
 )
 {
-    while ( (ascii_read_status() & 0x80) == 0x80 );
+    while ( ascii_busy() );
 
     delay_mikro     (     8     );
     ascii_write_cmd (    cmd    );
@@ -205,7 +223,7 @@ void ascii_data(
     u32  delay_dur
 )
 {
-    while ( (ascii_read_status() & 0x80) == 0x80 );
+    while ( ascii_busy() );
 
     delay_mikro      (     8     );
     ascii_write_data (    cmd    );
@@ -229,29 +247,3 @@ void ascii_init(void)
     // Entry Mode Set
     ascii_command(0b00000100, delay_mikro, 40);
 }
-
-
-/**
- * @brief Defines a way of accessing the rows and columns of the ASCII display.
- * @param row An integer in range [1, 20]
- * @param column An integer in range [1, 2]
- */
-void ascii_goto(u32 row, u32 column)
-{
-    u32 address = row - 1;
-
-    if (column == 2)
-        address += 0x40;
-
-    ascii_write_cmd( 0x80 | address );
-}
-
-
-/**
- * @brief Write a character to the ASCII display.
- * @param c The character to output. Viewed as ASCII.
- */
-void ascii_write_char(u8 c)
-{   char* s;
-    ascii_data(c, delay_mikro, 43);
-}
\ No newline at end of file
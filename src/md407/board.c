@@ -0,0 +1,55 @@
+#include "hal.h"
+
+// =============================================================================
+//                         INCLUDES & PRE-PROCESSOR
+
+#include "typedef.h"
+#include "memreg.h"
+#include "replay.h"
+
+
+// =============================================================================
+//                                REGISTERS
+
+static gpio_t *gpiod = (gpio_t*)GPIOD;   // GPIOD register
+static gpio_t *gpioe = (gpio_t*)GPIOE;   // GPIOE register
+
+
+// =============================================================================
+//                                  SET-UP
+
+void app_init(void)
+{
+    // Start clocks for port D and port E.
+    *(ulong*)0x40023830 = 0x18;
+    // Starta clocks for SYSCFG
+    *(ulong*)0x40023844 |= 0x4000;
+
+    gpiod->MODER_LOW  =     0x5555;
+    gpiod->MODER_HIGH =     0x5500;
+    gpiod->OSPEEDR    = 0x55555555;
+    gpiod->OTYPER    &=     0x00FF;
+    gpiod->PUPDR     &= 0x0000FFFF;
+    gpiod->PUPDR     |= 0x00AA0000;
+
+
+    gpioe->MODER   = 0x00005555;
+    gpioe->OSPEEDR = 0x55555555;
+
+    clock_init();
+    uart_init();
+
+#ifdef PONG_RECORD
+    // Send the input of every match over the serial port, see replay.h. Lines
+    // are recorded from the frame, so uart_puts() only queues them, and the
+    // serial port's interrupt sends them while the game runs.
+    replay_record_to(uart_puts);
+#endif
+}
+
+
+void app_finish(void)
+{
+    while (true)
+        wait_for_interrupt();
+}
@@ -0,0 +1,164 @@
+#include "clock.h"
+
+// =============================================================================
+//                         INCLUDES & PRE-PROCESSOR
+
+#include "typedef.h"
+#include "memreg.h"
+
+
+// The core clock of the MD407, used if the clock can't be measured.
+#define CORE_MHZ 168
+
+// How long to measure the clock for, in microseconds of TIM6.
+#define CALIBRATION_US 1000
+
+
+// =============================================================================
+//                                GLOBAL DATA
+
+static u32 (*source)(void) = NULL;
+static u32 ticks_per_us    = CORE_MHZ;
+
+// The number of times SysTick has wrapped, when it is the source.
+static volatile u32 systick_wraps = 0;
+
+
+// =============================================================================
+//                                 FUNCTIONS
+
+static u32 dwt_ticks(void)
+{
+    return *DWT_CYCCNT;
+}
+
+
+static void systick_irq_handler(void)
+{
+    systick_wraps++;
+}
+
+
+/**
+ * @brief SysTick counts down from 0xFFFFFF. Count the wraps in the interrupt
+ *        and combine them with the counter into a 32-bit up-counter.
+ *
+ *        With interrupts masked, a wrap can have happened without being
+ *        counted yet. Its interrupt is then pending, so it is added here, and
+ *        the counter is read again to be sure it is from after the wrap. Only
+ *        one wrap can be made up for, so interrupts must not stay masked for
+ *        2^24 cycles, about 100 ms.
+ */
+static u32 systick_ticks(void)
+{
+    systick_t *systick = (systick_t*)SYSTICK;
+    u32 wraps, value;
+
+    // Re-read if a wrap was counted while reading.
+    do
+    {
+        wraps = systick_wraps;
+        value = systick->VAL_VALUE;
+
+        if (*SCB_ICSR & BIT_PENDST_SET)
+        {
+            wraps++;
+            value = systick->VAL_VALUE;
+        }
+    } while (wraps != systick_wraps);
+
+    return (wraps << 24) | (0xFFFFFF - value);
+}
+
+
+/**
+ * @brief Use the DWT cycle counter if the core has one that runs, otherwise
+ *        let SysTick run freely with a wrap interrupt.
+ */
+static void select_source(void)
+{
+    *DEMCR     |= DEMCR_TRCENA;
+    *DWT_CTRL  |= DWT_CTRL_CYCCNTENA;
+
+    u32 start = *DWT_CYCCNT;
+    for (volatile int i = 0; i < 10; i++);
+
+    if (*DWT_CYCCNT != start)
+    {
+        source = dwt_ticks;
+        return;
+    }
+
+    systick_t *systick = (systick_t*)SYSTICK;
+
+    *VTOR_SYSTICK_IRQ   = systick_irq_handler;
+    systick->CTRL       = 0;
+    systick->LOAD_VALUE = 0xFFFFFF;
+    systick->VAL_VALUE  = 0;
+    systick->CTRL       = 7;    // Core clock, interrupt, enable.
+
+    source = systick_ticks;
+}
+
+
+/**
+ * @brief Count the ticks of the source during CALIBRATION_US of TIM6. In the
+ *        simulator, both run on simulated time, so delays come out right
+ *        there as well as on the board.
+ */
+static void calibrate(void)
+{
+    tim_t *tim6 = (tim_t*)TIM6;
+
+    // Start the clock for TIM6 and let it count microseconds.
+    *(ulong*)0x40023840 |= 0x10;
+
+    tim6->CR1       = 0;
+    tim6->PSC       = 84 - 1;
+    tim6->ARR       = 0xFFFF;
+    tim6->EGR.UG    = 1;
+    tim6->CR1_B.CEN = 1;
+
+    // Give up if TIM6 doesn't run, and keep the nominal rate.
+    u32 start = source();
+    while (tim6->CNT == 0)
+        if (source() - start > 100 * CORE_MHZ * CALIBRATION_US)
+            goto done;
+
+    u16 c0 = tim6->CNT;
+    u32 t0 = source();
+    while ((u16)(tim6->CNT - c0) < CALIBRATION_US);
+    u32 t1 = source();
+
+    ticks_per_us = (t1 - t0 + CALIBRATION_US / 2) / CALIBRATION_US;
+    if (ticks_per_us == 0)
+        ticks_per_us = 1;
+
+done:
+    tim6->CR1 = 0;
+}
+
+
+void clock_init(void)
+{
+    select_source();
+    calibrate();
+}
+
+
+u32 now(void)
+{
+    return source();
+}
+
+
+u32 clock_ticks_per_us(void)
+{
+    return ticks_per_us;
+}
+
+
+void delay_until(u32 deadline)
+{
+    while ((i32)(deadline - source()) > 0);
+}
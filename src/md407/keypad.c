@@ -0,0 +1,35 @@
+#include "keyb.h"
+
+#include "memreg.h"
+
+
+void activate_row(u32 row)
+{
+    volatile gpio_t *gpiod = (gpio_t*)GPIOD;
+
+    switch (row)
+    {
+    case 1:
+        gpiod->ODR_HIGH = 0x10; break;
+
+    case 2:
+        gpiod->ODR_HIGH = 0x20; break;
+
+    case 3:
+        gpiod->ODR_HIGH = 0x40; break;
+
+    case 4:
+        gpiod->ODR_HIGH = 0x80; break;
+
+    default: break;
+        // NAUGHTY MOVE
+    }
+}
+
+
+u8 read_columns(void)
+{
+    volatile gpio_t *gpiod = (gpio_t*)GPIOD;
+
+    return gpiod->IDR_HIGH & 0x0F;
+}
@@ -0,0 +1,175 @@
+#include "ks0108.h"
+
+// =============================================================================
+//                         INCLUDES & PRE-PROCESSOR
+
+#include "clock.h"
+#include "delay.h"
+#include "typedef.h"
+#include "memreg.h"
+
+
+// The fewest cycles a turn of spin() can take. Counting low makes the waits
+// longer than needed, never shorter.
+#define SPIN_CYCLES 2
+
+
+// =============================================================================
+//                                REGISTERS
+
+// The control signals are on the low byte of port E and the data bus on the
+// high byte. The text display shares the port.
+static gpio_t *gpioe = (gpio_t*)GPIOE;
+
+
+// =============================================================================
+//                                GLOBAL DATA
+
+// The turns of spin() that take at least 250 ns. Set by ks0108_init() from
+// the measured clock, which counts core cycles.
+static u32 turns_250ns = 0;
+
+
+// =============================================================================
+//                                 FUNCTIONS
+
+/**
+ * @brief The text display is driven from the ticker interrupt, which changes
+ *        the control signals. Every bus cycle is made with interrupts masked,
+ *        and writes all of the control signals, so it doesn't matter what the
+ *        interrupt left behind. The waits within a cycle spin, and the wait
+ *        after it is made once interrupts are back on.
+ */
+static u32 mask_interrupts(void)
+{
+    u32 primask;
+    __asm__ volatile ("MRS %0, PRIMASK\n CPSID I" : "=r" (primask) :: "memory");
+    return primask;
+}
+
+
+static void restore_interrupts(u32 primask)
+{
+    __asm__ volatile ("MSR PRIMASK, %0" :: "r" (primask) : "memory");
+}
+
+
+/**
+ * @brief Wait without reading the clock. The SysTick clock counts its wraps in
+ *        an interrupt, so it mustn't be waited on with interrupts masked.
+ */
+static void spin(u32 turns)
+{
+    while (turns--)
+        __asm__ volatile ("");
+}
+
+
+/**
+ * @brief The control signals that select the given controllers, out of reset.
+ */
+static u8 select(u8 chips)
+{
+    return B_RST
+         | (chips & KS0108_LEFT  ? B_CS1 : 0)
+         | (chips & KS0108_RIGHT ? B_CS2 : 0);
+}
+
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+/**
+ * @brief One read cycle. E is held for at least 450 ns, and the data is valid
+ *        320 ns after its rising edge.
+ */
+static u8 read_cycle(u8 ctrl)
+{
+    u32 primask = mask_interrupts();
+
+    gpioe->MODER_HIGH = 0x0000;
+    gpioe->ODR_LOW    = ctrl | B_RW;
+    spin(turns_250ns);
+
+    gpioe->ODR_LOW = ctrl | B_RW | B_E;
+    spin(2 * turns_250ns);
+
+    u8 data = gpioe->IDR_HIGH;
+
+    gpioe->ODR_LOW    = ctrl | B_RW;
+    gpioe->MODER_HIGH = 0x5555;
+
+    restore_interrupts(primask);
+    delay_250ns();
+
+    return data;
+}
+
+
+/**
+ * @brief One write cycle. The data is latched on the falling edge of E.
+ */
+static void write_cycle(u8 ctrl, u8 data)
+{
+    u32 primask = mask_interrupts();
+
+    gpioe->ODR_LOW  = ctrl;
+    gpioe->ODR_HIGH = data;
+    spin(turns_250ns);
+
+    gpioe->ODR_LOW = ctrl | B_E;
+    spin(2 * turns_250ns);
+
+    gpioe->ODR_LOW = ctrl;
+
+    restore_interrupts(primask);
+    delay_250ns();
+}
+
+
+/**
+ * @brief Wait until each selected controller has cleared its busy flag. The
+ *        status can only be read from one at a time.
+ */
+static void wait_ready(u8 chips)
+{
+    if (chips & KS0108_LEFT)
+        while (read_cycle(select(KS0108_LEFT)) & KS0108_STATUS_BUSY);
+
+    if (chips & KS0108_RIGHT)
+        while (read_cycle(select(KS0108_RIGHT)) & KS0108_STATUS_BUSY);
+}
+
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+void ks0108_init(void)
+{
+    turns_250ns = (clock_ticks_per_us() / 4 + SPIN_CYCLES - 1) / SPIN_CYCLES;
+
+    gpioe->ODR_LOW = 0;
+    delay_mikro(10);
+
+    gpioe->ODR_LOW = B_RST;
+    delay_mikro(10);
+}
+
+
+void ks0108_command(u8 chips, u8 cmd)
+{
+    wait_ready(chips);
+    write_cycle(select(chips), cmd);
+}
+
+
+void ks0108_write(u8 chips, u8 data)
+{
+    wait_ready(chips);
+    write_cycle(select(chips) | B_RS, data);
+}
+
+
+u8 ks0108_read(u8 chip)
+{
+    wait_ready(chip);
+    return read_cycle(select(chip) | B_RS);
+}
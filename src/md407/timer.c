@@ -0,0 +1,104 @@
+#include "timer.h"
+
+// =============================================================================
+//                         INCLUDES & PRE-PROCESSOR
+
+#include "typedef.h"
+#include "memreg.h"
+#include "cycles.h"
+
+
+// The frequency TIM6 counts at, after the prescaler. The timer is clocked from
+// APB1 at 84 MHz.
+#define TIM6_COUNT_HZ 1000000
+
+
+// =============================================================================
+//                                GLOBAL DATA
+
+static void (*timer_handler)(void) = NULL;
+
+// The time awake up to the last sleep, and when the CPU last woke up.
+static u32 busy        = 0;
+static u32 awake_since = 0;
+
+
+// =============================================================================
+//                                 FUNCTIONS
+
+static void tim6_irq_handler(void)
+{
+    tim_t *tim6 = (tim_t*)TIM6;
+
+    // Acknowledge the update interrupt.
+    tim6->SR.UIF = 0;
+
+    timer_handler();
+}
+
+
+/**
+ * @brief Start TIM6 as a periodic update interrupt.
+ */
+void timer_start(u32 hz, void (*handler)(void))
+{
+    tim_t *tim6 = (tim_t*)TIM6;
+
+    timer_handler = handler;
+
+    // Start the clock for TIM6.
+    *(ulong*)0x40023840 |= 0x10;
+
+    tim6->CR1 = 0;
+    tim6->PSC = 84000000 / TIM6_COUNT_HZ - 1;
+    tim6->ARR = TIM6_COUNT_HZ / hz - 1;
+    tim6->CNT = 0;
+
+    *VTOR_TIM6_IRQ   = tim6_irq_handler;
+    *NVIC_TIM6_ISER |= NVIC_TIM6_IRQ_BPOS;
+
+    tim6->DIER_B.UIE = 1;
+    tim6->CR1_B.ARPE = 1;
+    tim6->CR1_B.CEN  = 1;
+}
+
+
+/**
+ * @brief The software interrupt is PendSV, at the lowest priority, so TIM6 can
+ *        interrupt it.
+ */
+void soft_irq_attach(void (*handler)(void))
+{
+    *SCB_SHPR3 |= 0xFFu << 16;
+    *VTOR_PENDSV_IRQ = handler;
+}
+
+
+void soft_irq_raise(void)
+{
+    *SCB_ICSR = BIT_PENDSV_SET;
+}
+
+
+/**
+ * @brief Interrupts are masked around WFI. A pending interrupt still wakes the
+ *        CPU, but is only taken once they are unmasked, so the time it takes is
+ *        counted as awake.
+ */
+void wait_for_interrupt(void)
+{
+    u32 primask;
+    __asm__ volatile ("MRS %0, PRIMASK\n CPSID I" : "=r" (primask) :: "memory");
+
+    busy += cycles_now() - awake_since;
+    __asm__ volatile ("DSB\n WFI" ::: "memory");
+    awake_since = cycles_now();
+
+    __asm__ volatile ("MSR PRIMASK, %0" :: "r" (primask) : "memory");
+}
+
+
+u32 busy_cycles(void)
+{
+    return busy + (cycles_now() - awake_since);
+}
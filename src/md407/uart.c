@@ -0,0 +1,71 @@
+#include "uart.h"
+
+#include "memreg.h"
+#include "timer.h"
+
+
+// `head` is only written by the game and `tail` only by the interrupt, so no
+// locking is needed.
+static char         tx[UART_TX_SIZE];
+static volatile u32 head = 0;
+static volatile u32 tail = 0;
+
+
+/**
+ * @brief Send the next character, and stop the interrupt once the buffer is
+ *        empty.
+ */
+static void usart1_irq_handler(void)
+{
+    if (tail == head)
+    {
+        *USART1_CR1 &= ~USART_CR1_TXEIE;
+        return;
+    }
+
+    *USART1_DR = tx[tail];
+    tail = (tail + 1) & (UART_TX_SIZE - 1);
+}
+
+
+/**
+ * @brief USART1 has already been set up by the runtime.
+ */
+void uart_init(void)
+{
+    *VTOR_USART1_IRQ   = usart1_irq_handler;
+    *NVIC_USART1_ISER |= NVIC_USART1_IRQ_BPOS;
+}
+
+
+static void push(char c)
+{
+    u32 next = (head + 1) & (UART_TX_SIZE - 1);
+
+    // Wait for the interrupt to make room rather than lose output.
+    while (next == tail)
+        wait_for_interrupt();
+
+    tx[head] = c;
+
+    // The character must be in the buffer before the interrupt can see it.
+    __asm__ volatile ("" ::: "memory");
+    head = next;
+}
+
+
+/**
+ * @brief Newlines are sent as CR LF. The interrupt clears TXEIE itself, so it
+ *        is set with interrupts masked, not to lose a change in between.
+ */
+void uart_putc(char c)
+{
+    if (c == '\n')
+        push('\r');
+    push(c);
+
+    u32 primask;
+    __asm__ volatile ("MRS %0, PRIMASK\n CPSID I" : "=r" (primask) :: "memory");
+    *USART1_CR1 |= USART_CR1_TXEIE;
+    __asm__ volatile ("MSR PRIMASK, %0" :: "r" (primask) : "memory");
+}
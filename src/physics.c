@@ -0,0 +1,290 @@
+#include "physics.h"
+
+// =============================================================================
+//                         INCLUDES & PRE-PROCESSOR
+
+#include "entity.h"
+#include "graphics.h"
+#include "fixed.h"
+#include "typedef.h"
+
+
+// A time later than any collision within a tick.
+#define TOI_NEVER (TOI_ONE + 1)
+
+// The bounds of the playing field in fixed-point.
+#define FX_LEFT   INT_TO_FX(FIELD_LEFT)
+#define FX_RIGHT  INT_TO_FX(FIELD_RIGHT)
+#define FX_TOP    INT_TO_FX(FIELD_TOP)
+#define FX_BOTTOM INT_TO_FX(FIELD_BOTTOM)
+
+
+// =============================================================================
+//                                GLOBAL DATA
+
+/**
+ * @brief The direction of the ball after hitting each zone of a paddle, top
+ *        zone first, as a unit vector in fixed-point. The angles are 15
+ *        degrees apart: +-7.5, +-22.5, +-37.5 and +-52.5 degrees. `x` is the
+ *        speed away from the paddle.
+ */
+static const struct
+{
+    fixed x;
+    fixed y;
+} BOUNCE_TABLE[BOUNCE_ZONES] =
+{
+    { 156, -203 },
+    { 203, -156 },
+    { 237,  -98 },
+    { 254,  -33 },
+    { 254,   33 },
+    { 237,   98 },
+    { 203,  156 },
+    { 156,  203 },
+};
+
+
+// =============================================================================
+//                            SWEPT COLLISIONS
+
+/**
+ * @brief Find when a moving interval [b0, b1] starts and stops overlapping a
+ *        fixed interval [a0, a1], as fractions of TOI_ONE of the motion `m`.
+ *
+ * @return false if the intervals never overlap.
+ */
+static bool axis_overlap(
+    fixed b0, fixed b1,
+    fixed a0, fixed a1,
+    fixed m,
+    i32 *enter, i32 *leave
+)
+{
+    if (m == 0)
+    {
+        if (b1 < a0 || b0 > a1)
+            return false;
+
+        *enter = -TOI_NEVER;
+        *leave =  TOI_NEVER;
+        return true;
+    }
+
+    if (m > 0)
+    {
+        *enter = (a0 - b1) * TOI_ONE / m;
+        *leave = (a1 - b0) * TOI_ONE / m;
+    }
+    else
+    {
+        *enter = (a1 - b0) * TOI_ONE / m;
+        *leave = (a0 - b1) * TOI_ONE / m;
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief Sweep the ball's box along (mx, my) against a paddle's box.
+ *
+ * @param axis Set to 'x' or 'y', the axis the ball hits the paddle along.
+ * @return The time of impact, or TOI_NEVER if the ball doesn't start touching
+ *         the paddle during the motion.
+ */
+static i32 sweep_paddle(Body *ball, fixed w, fixed h, fixed mx, fixed my, P_Object paddle, char *axis)
+{
+    i32 ex, lx, ey, ly;
+
+    bool x = axis_overlap(
+        ball->pos_x,   ball->pos_x   + w,
+        paddle->pos_x, paddle->pos_x + INT_TO_FX(paddle->sprite->width),
+        mx, &ex, &lx
+    );
+    bool y = axis_overlap(
+        ball->pos_y,   ball->pos_y   + h,
+        paddle->pos_y, paddle->pos_y + INT_TO_FX(paddle->sprite->height),
+        my, &ey, &ly
+    );
+
+    if (!x || !y)
+        return TOI_NEVER;
+
+    i32 enter = ex > ey ? ex : ey;
+    i32 leave = lx < ly ? lx : ly;
+
+    // Already touching at the start, or not touching during this motion.
+    if (enter <= 0 || enter > leave || enter > TOI_ONE)
+        return TOI_NEVER;
+
+    *axis = ex >= ey ? 'x' : 'y';
+    return enter;
+}
+
+
+/**
+ * @brief Find when a coordinate moving by `m` crosses `limit`. Moving in the
+ *        direction given by `sign` (+1 or -1) past `limit` is a collision.
+ */
+static i32 sweep_wall(fixed pos, fixed m, fixed limit, int sign)
+{
+    if (m * sign <= 0 || (pos + m - limit) * sign <= 0)
+        return TOI_NEVER;
+
+    return (limit - pos) * TOI_ONE / m;
+}
+
+
+/**
+ * @brief Send the ball away from the front of a paddle, at the angle given by
+ *        where on the paddle the centre of the ball is.
+ */
+static void bounce_off_paddle(Body *ball, fixed h, P_Object paddle, fixed speed)
+{
+    fixed centre = ball->pos_y + h / 2;
+    fixed height = INT_TO_FX(paddle->sprite->height);
+    int   zone   = (centre - paddle->pos_y) * BOUNCE_ZONES / height;
+
+    if (zone < 0)                 zone = 0;
+    if (zone > BOUNCE_ZONES - 1)  zone = BOUNCE_ZONES - 1;
+
+    fixed away = FX_MUL(speed, BOUNCE_TABLE[zone].x);
+
+    ball->dir_x = ball->dir_x > 0 ? -away : away;
+    ball->dir_y = FX_MUL(speed, BOUNCE_TABLE[zone].y);
+}
+
+
+BallStep ball_step(Body *ball, P_Sprite sprite, P_Object l_paddle, P_Object r_paddle, fixed speed)
+{
+    BallStep result = { 0, 0, 0 };
+
+    const fixed w = INT_TO_FX(sprite->width);
+    const fixed h = INT_TO_FX(sprite->height);
+
+    // The fraction of the tick that is left to simulate.
+    i32 remaining = TOI_ONE;
+
+    for (int bounce = 0; bounce <= MAX_BOUNCES && remaining > 0; bounce++)
+    {
+        fixed mx = ball->dir_x * remaining / TOI_ONE;
+        fixed my = ball->dir_y * remaining / TOI_ONE;
+
+        if (mx == 0 && my == 0)
+            break;
+
+        // Find the earliest event of this motion.
+        i32  t     = TOI_NEVER;
+        char event = 0;
+        char axis  = 0;
+        P_Object hit = NULL;
+        P_Object paddles[] = { l_paddle, r_paddle };
+
+        for (int i = 0; i < 2; i++)
+        {
+            char a;
+            i32  tp = sweep_paddle(ball, w, h, mx, my, paddles[i], &a);
+            if (tp < t)
+            {
+                t     = tp;
+                event = 'p';
+                axis  = a;
+                hit   = paddles[i];
+            }
+        }
+
+        i32 tw;
+        if ((tw = sweep_wall(ball->pos_y,     my, FX_TOP,    -1)) < t)
+            t = tw, event = 'u';
+        if ((tw = sweep_wall(ball->pos_y + h, my, FX_BOTTOM, +1)) < t)
+            t = tw, event = 'd';
+        if ((tw = sweep_wall(ball->pos_x,     mx, FX_LEFT,   -1)) < t)
+            t = tw, event = 'l';
+        if ((tw = sweep_wall(ball->pos_x + w, mx, FX_RIGHT,  +1)) < t)
+            t = tw, event = 'r';
+
+        if (event == 0)
+        {
+            ball->pos_x += mx;
+            ball->pos_y += my;
+            break;
+        }
+
+        // Move the ball to the point of contact.
+        ball->pos_x += mx * t / TOI_ONE;
+        ball->pos_y += my * t / TOI_ONE;
+        remaining   -= remaining * t / TOI_ONE;
+
+        switch (event)
+        {
+        // Snap to the face that was hit, so rounding can't leave a gap or
+        // push the ball into the paddle.
+        case 'p':
+            if (axis == 'x')
+            {
+                ball->pos_x = mx > 0 ? hit->pos_x - w
+                                     : hit->pos_x + INT_TO_FX(hit->sprite->width);
+                bounce_off_paddle(ball, h, hit, speed);
+            }
+            else
+            {
+                ball->pos_y = my > 0 ? hit->pos_y - h
+                                     : hit->pos_y + INT_TO_FX(hit->sprite->height);
+                ball->dir_y *= -1;
+            }
+            result.paddle_hits++;
+            break;
+
+        case 'u':
+            ball->pos_y = FX_TOP;
+            ball->dir_y *= -1;
+            result.wall_hits++;
+            break;
+
+        case 'd':
+            ball->pos_y = FX_BOTTOM - h;
+            ball->dir_y *= -1;
+            result.wall_hits++;
+            break;
+
+        // The ball left the field. Let it finish the tick outside.
+        case 'l':
+        case 'r':
+            ball->pos_x += mx * (TOI_ONE - t) / TOI_ONE;
+            ball->pos_y += my * (TOI_ONE - t) / TOI_ONE;
+            result.scored = event;
+            return result;
+        }
+    }
+
+    return result;
+}
+
+
+void entities_step(P_Object l_paddle, P_Object r_paddle, fixed speed, BallStep *results)
+{
+    for (int i = 0; i < entities.count; i++)
+    {
+        entities.prev_x[i] = entities.pos_x[i];
+        entities.prev_y[i] = entities.pos_y[i];
+
+        Body ball =
+        {
+            entities.pos_x[i],
+            entities.pos_y[i],
+            entities.dir_x[i],
+            entities.dir_y[i]
+        };
+
+        results[i] = ball_step(
+            &ball, entity_sprite(entities.sprite[i]),
+            l_paddle, r_paddle, speed
+        );
+
+        entities.pos_x[i] = ball.pos_x;
+        entities.pos_y[i] = ball.pos_y;
+        entities.dir_x[i] = ball.dir_x;
+        entities.dir_y[i] = ball.dir_y;
+    }
+}
@@ -0,0 +1,181 @@
+#include "profile.h"
+
+// =============================================================================
+//                         INCLUDES & PRE-PROCESSOR
+
+#include "cycles.h"
+#include "uart.h"
+#include "typedef.h"
+
+
+// =============================================================================
+//                                GLOBAL DATA
+
+/**
+ * @brief The statistics of one stage since the last report.
+ */
+typedef struct
+{
+    u32                n;
+    u32                min;
+    u32                max;
+    unsigned long long sum;
+    u16                histogram[PROF_BUCKETS];
+} StageStats;
+
+static StageStats stats[PROF_STAGES];
+
+static const char *const STAGE_NAMES[PROF_STAGES] =
+{
+    "input", "physics", "render", "frame"
+};
+
+static u32 frame_start;
+static u32 mark;
+
+
+// =============================================================================
+//                                 FUNCTIONS
+
+/**
+ * @brief Map a number of cycles to a histogram bucket. Values below
+ *        PROF_SUB_BUCKETS get a bucket each; above that, each power of two is
+ *        split into PROF_SUB_BUCKETS equal parts.
+ */
+static u32 bucket_of(u32 cycles)
+{
+    if (cycles < PROF_SUB_BUCKETS)
+        return cycles;
+
+    u32 msb = 31 - __builtin_clz(cycles);
+    u32 sub = (cycles >> (msb - PROF_SUB_BITS)) & (PROF_SUB_BUCKETS - 1);
+
+    return (msb - PROF_SUB_BITS + 1) * PROF_SUB_BUCKETS + sub;
+}
+
+
+/**
+ * @brief Return the largest number of cycles that maps to a bucket.
+ */
+static u32 bucket_limit(u32 bucket)
+{
+    if (bucket < PROF_SUB_BUCKETS)
+        return bucket;
+
+    u32 msb = bucket / PROF_SUB_BUCKETS + PROF_SUB_BITS - 1;
+    u32 sub = bucket % PROF_SUB_BUCKETS;
+
+    u32 base = (PROF_SUB_BUCKETS + sub) << (msb - PROF_SUB_BITS);
+    return base + (1u << (msb - PROF_SUB_BITS)) - 1;
+}
+
+
+static void reset(void)
+{
+    for (int s = 0; s < PROF_STAGES; s++)
+    {
+        stats[s].n   = 0;
+        stats[s].min = 0xFFFFFFFF;
+        stats[s].max = 0;
+        stats[s].sum = 0;
+
+        for (int b = 0; b < PROF_BUCKETS; b++)
+            stats[s].histogram[b] = 0;
+    }
+}
+
+
+static void record(ProfStage stage, u32 cycles)
+{
+    StageStats *st = &stats[stage];
+
+    st->n++;
+    st->sum += cycles;
+    if (cycles < st->min) st->min = cycles;
+    if (cycles > st->max) st->max = cycles;
+
+    u16 *count = &st->histogram[bucket_of(cycles)];
+    if (*count != 0xFFFF)
+        (*count)++;
+}
+
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+void profile_init(void)
+{
+    cycles_init();
+    reset();
+
+    frame_start = cycles_now();
+    mark        = frame_start;
+}
+
+
+void profile_frame_start(void)
+{
+    frame_start = cycles_now();
+    mark        = frame_start;
+}
+
+
+void profile_lap(ProfStage stage)
+{
+    u32 now = cycles_now();
+
+    record(stage, now - mark);
+    mark = now;
+}
+
+
+void profile_frame_end(void)
+{
+    u32 now = cycles_now();
+
+    record(PROF_FRAME, now - frame_start);
+}
+
+
+void profile_report(void)
+{
+    uart_puts("prof cycles_per_us=");
+    uart_put_u32(cycles_per_us());
+    uart_putc('\n');
+
+    for (int s = 0; s < PROF_STAGES; s++)
+    {
+        StageStats *st = &stats[s];
+
+        if (st->n == 0)
+            continue;
+
+        // The smallest bucket limit with at least 99% of the samples at or
+        // below it.
+        u32 target = st->n - st->n / 100;
+        u32 seen   = 0;
+        u32 p99    = st->max;
+
+        for (u32 b = 0; b < PROF_BUCKETS; b++)
+        {
+            seen += st->histogram[b];
+            if (seen >= target)
+            {
+                p99 = bucket_limit(b);
+                break;
+            }
+        }
+        if (p99 > st->max)
+            p99 = st->max;
+
+        uart_puts("prof ");
+        uart_puts(STAGE_NAMES[s]);
+        uart_puts(" n=");   uart_put_u32(st->n);
+        uart_puts(" min="); uart_put_u32(st->min);
+        uart_puts(" avg="); uart_put_u32((u32)(st->sum / st->n));
+        uart_puts(" max="); uart_put_u32(st->max);
+        uart_puts(" p99="); uart_put_u32(p99);
+        uart_putc('\n');
+    }
+
+    reset();
+}
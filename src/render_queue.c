@@ -0,0 +1,198 @@
+#include "render_queue.h"
+
+// =============================================================================
+//                         INCLUDES & PRE-PROCESSOR
+
+#include "display_driver.h"
+#include "ticker.h"
+#include "timer.h"
+#include "typedef.h"
+
+
+// =============================================================================
+//                                GLOBAL DATA
+
+/**
+ * @brief A run of column bytes, stored in the `bytes` of its frame.
+ */
+typedef struct
+{
+    u8  page;
+    u8  column;
+    u8  n;
+    u16 offset;
+} Run;
+
+
+/**
+ * @brief The page writes of one frame, in the order they were recorded.
+ */
+typedef struct
+{
+    Run runs[RENDER_MAX_RUNS];
+    u8  bytes[RENDER_MAX_BYTES];
+    u32 n_runs;
+    u32 n_bytes;
+} Frame;
+
+
+RenderStats render_stats;
+
+// The game records into `frames[recording]` while the interrupt sends the
+// other one. `sending` is set by the game to hand a frame over, and cleared by
+// the interrupt when all of it has been sent, so no locking is needed:
+//
+// - While `sending` is false, the game owns everything here and the interrupt
+//   touches nothing.
+// - While it is true, the interrupt owns the frame being sent, `run_index`,
+//   `run_done`, `bytes_left` and `render_stats.bytes`. The game only records
+//   into `frames[recording]`, reads `bytes_left`, and doesn't change
+//   `recording`, which the interrupt reads to find its frame.
+static Frame        frames[2];
+static u32          recording = 0;
+static volatile bool sending  = false;
+
+// How far the interrupt has come in the frame it is sending.
+static u32          run_index   = 0;
+static u32          run_done    = 0;
+static volatile u32 bytes_left  = 0;
+
+
+// =============================================================================
+//                                 FUNCTIONS
+
+/**
+ * @brief Send up to RENDER_SLICE_BYTES of the frame. Runs from the software
+ *        interrupt.
+ */
+static void render_queue_pump(void)
+{
+    if (!sending)
+        return;
+
+    const Frame *frame  = &frames[recording ^ 1];
+    u32          budget = RENDER_SLICE_BYTES;
+
+    while (run_index < frame->n_runs && budget > 0)
+    {
+        const Run *run = &frame->runs[run_index];
+
+        u32 n = run->n - run_done;
+        if (n > budget)
+            n = budget;
+
+        graphic_write_page(
+            run->page, run->column + run_done, &frame->bytes[run->offset + run_done], n
+        );
+
+        run_done   += n;
+        budget     -= n;
+        bytes_left -= n;
+
+        if (run_done == run->n)
+        {
+            run_index++;
+            run_done = 0;
+        }
+    }
+
+    render_stats.bytes += RENDER_SLICE_BYTES - budget;
+
+    if (run_index == frame->n_runs)
+        sending = false;
+}
+
+
+/**
+ * @brief Keep the software interrupt going, once a millisecond, until the
+ *        frame has been sent.
+ */
+static void render_queue_kick(void)
+{
+    if (sending)
+        soft_irq_raise();
+}
+
+
+void render_queue_init(void)
+{
+    soft_irq_attach(render_queue_pump);
+    ticker_attach(render_queue_kick);
+}
+
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+void render_queue_write_page(u8 page, u8 column, const u8 *bytes, u8 n)
+{
+    Frame *frame = &frames[recording];
+
+    if (frame->n_runs == RENDER_MAX_RUNS || frame->n_bytes + n > RENDER_MAX_BYTES)
+    {
+        render_queue_submit();
+        frame = &frames[recording];
+    }
+
+    Run *run = &frame->runs[frame->n_runs++];
+    run->page   = page;
+    run->column = column;
+    run->n      = n;
+    run->offset = frame->n_bytes;
+
+    for (u8 i = 0; i < n; i++)
+        frame->bytes[frame->n_bytes++] = bytes[i];
+}
+
+
+void render_queue_submit(void)
+{
+    Frame *frame = &frames[recording];
+
+    if (frame->n_runs == 0)
+        return;
+
+    if (sending)
+    {
+        render_stats.stalls++;
+        render_queue_drain();
+    }
+
+    run_index  = 0;
+    run_done   = 0;
+    bytes_left = frame->n_bytes;
+
+    if (bytes_left > render_stats.max_pending)
+        render_stats.max_pending = bytes_left;
+    render_stats.frames++;
+
+    // Swap the buffers before handing the frame over.
+    recording ^= 1;
+    frames[recording].n_runs  = 0;
+    frames[recording].n_bytes = 0;
+
+    // Everything above must be written before the interrupt can see the frame.
+    // Only `sending` is volatile, so the compiler could otherwise move the
+    // stores to the frame, `recording` and `run_index` after it.
+    __asm__ volatile ("" ::: "memory");
+    sending = true;
+    soft_irq_raise();
+}
+
+
+bool render_queue_busy(void)
+{
+    return sending;
+}
+
+
+u32 render_queue_pending(void)
+{
+    return sending ? bytes_left : 0;
+}
+
+
+void render_queue_drain(void)
+{
+    while (sending)
+        wait_for_interrupt();
+}
@@ -0,0 +1,273 @@
+#include "replay.h"
+
+// =============================================================================
+//                         INCLUDES & PRE-PROCESSOR
+
+#include "typedef.h"
+
+
+// =============================================================================
+//                                GLOBAL DATA
+
+ReplayStats replay_stats = { 0, 0, 0, 0, REPLAY_HASH_INIT };
+
+// Where recorded lines are sent, or NULL if not recording.
+static void (*sink)(const char *line) = NULL;
+
+// The rest of the log being replayed, or NULL if not replaying.
+static const char *log_text = NULL;
+
+// The line that is being recorded or replayed. `run` counts the frames that
+// have been added to it, or are left of it when replaying.
+static u32 run       = 0;
+static u32 run_steps = 0;
+static u16 run_keys  = 0;
+static u32 run_hash  = 0;
+
+// The key of the last start line read from the log.
+static u8 start_key = 0;
+
+
+// =============================================================================
+//                                 FUNCTIONS
+
+u32 replay_hash(u32 hash, u32 word)
+{
+    // FNV-1a, a byte at a time.
+    for (int i = 0; i < 4; i++)
+    {
+        hash ^= word & 0xFF;
+        hash *= 0x01000193;
+        word >>= 8;
+    }
+
+    return hash;
+}
+
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+void replay_record_to(void (*put)(const char *line))
+{
+    sink = put;
+    run  = 0;
+
+    sink("# pong input log: <frames> <steps> <keys> <hash>\n");
+}
+
+
+/**
+ * @brief Write `n` in base `base`, and return the end of the text.
+ */
+static char *put_number(char *s, u32 n, u32 base)
+{
+    char digits[10];
+    int  i = 0;
+
+    do
+    {
+        digits[i++] = "0123456789abcdef"[n % base];
+        n /= base;
+    } while (n);
+
+    while (i)
+        *s++ = digits[--i];
+
+    return s;
+}
+
+
+void replay_flush(void)
+{
+    if (!sink || run == 0)
+        return;
+
+    char  line[40];
+    char *s = line;
+
+    s = put_number(s, run, 10);           *s++ = ' ';
+    s = put_number(s, run_steps, 10);     *s++ = ' ';
+    s = put_number(s, run_keys, 16);      *s++ = ' ';
+    s = put_number(s, replay_stats.hash, 16);
+    *s++ = '\n';
+    *s   = '\0';
+
+    sink(line);
+    run = 0;
+}
+
+
+void replay_record_start(u8 key)
+{
+    if (!sink)
+        return;
+
+    replay_flush();
+
+    char line[] = "s 0\n";
+    line[2] = "0123456789abcdef"[key & 0xF];
+    sink(line);
+}
+
+
+void replay_record(u32 steps, u16 keys)
+{
+    if (!sink)
+        return;
+
+    if (run > 0 && (steps != run_steps || keys != run_keys || run == REPLAY_MAX_RUN))
+        replay_flush();
+
+    run_steps = steps;
+    run_keys  = keys;
+    run++;
+}
+
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+void replay_load(const char *text)
+{
+    log_text = text;
+    run = 0;
+}
+
+
+bool replay_active(void)
+{
+    return log_text != NULL;
+}
+
+
+/**
+ * @brief Read a number in base `base`, and skip the blanks after it.
+ */
+static u32 get_number(const char **s, u32 base)
+{
+    u32 n = 0;
+
+    while (true)
+    {
+        char c = **s;
+        u32  v = (c >= '0' && c <= '9') ? (u32)(c - '0')
+               : (c >= 'a' && c <= 'f') ? (u32)(c - 'a' + 10)
+               : (c >= 'A' && c <= 'F') ? (u32)(c - 'A' + 10)
+               : base;
+
+        if (v >= base)
+            break;
+
+        n = n * base + v;
+        (*s)++;
+    }
+
+    while (**s == ' ' || **s == '\t')
+        (*s)++;
+
+    return n;
+}
+
+
+/**
+ * @brief Parse the next line of the log that starts a match or holds any
+ *        frames.
+ *
+ * @return 's' for a start line, 'f' for frames, or 0 at the end of the log.
+ */
+static char next_line(void)
+{
+    while (*log_text)
+    {
+        const char *s = log_text;
+
+        // Move `log_text` to the start of the following line.
+        while (*log_text && *log_text != '\n')
+            log_text++;
+        if (*log_text)
+            log_text++;
+
+        if (*s == '#')
+            continue;
+
+        if (*s == 's')
+        {
+            s++;
+            while (*s == ' ')
+                s++;
+            start_key = get_number(&s, 16);
+            return 's';
+        }
+
+        run       = get_number(&s, 10);
+        run_steps = get_number(&s, 10);
+        run_keys  = get_number(&s, 16);
+        run_hash  = get_number(&s, 16);
+
+        if (run > 0)
+            return 'f';
+    }
+
+    return 0;
+}
+
+
+bool replay_start(u8 *key)
+{
+    const char *at = log_text;
+
+    switch (next_line())
+    {
+    case 's':
+        *key = start_key;
+        return true;
+
+    // No start line. Leave the frames for replay_next().
+    case 'f':
+        log_text = at;
+        run      = 0;
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+
+bool replay_next(u32 *steps, u16 *keys)
+{
+    if (run == 0)
+    {
+        const char *at = log_text;
+
+        if (next_line() != 'f')
+        {
+            // Keep a start line for the next match.
+            log_text = at;
+            return false;
+        }
+    }
+
+    *steps = run_steps;
+    *keys  = run_keys;
+
+    return true;
+}
+
+
+void replay_end_frame(u32 state_hash)
+{
+    replay_stats.hash = replay_hash(replay_stats.hash, state_hash);
+
+    if (!log_text)
+        return;
+
+    replay_stats.frames++;
+
+    if (--run > 0)
+        return;
+
+    replay_stats.checks++;
+
+    if (replay_stats.hash != run_hash && replay_stats.mismatches++ == 0)
+        replay_stats.first_mismatch = replay_stats.frames;
+}
@@ -0,0 +1,250 @@
+#include "sched.h"
+
+// =============================================================================
+//                         INCLUDES & PRE-PROCESSOR
+
+#include "cycles.h"
+#include "ticker.h"
+#include "timer.h"
+#include "typedef.h"
+#include "uart.h"
+
+
+// =============================================================================
+//                                GLOBAL DATA
+
+static P_Task tasks[SCHED_MAX_TASKS];
+static u32    n_tasks = 0;
+
+// Each running timer is in the slot of the millisecond it expires in. The
+// wheel has been turned up to `wheel_ms`, so every timer that expired at or
+// before it has fired.
+static P_SoftTimer wheel[SCHED_WHEEL_SLOTS];
+static u32         wheel_ms = 0;
+
+// When the load was last reported, and busy_cycles() then.
+static u32 report_ms   = 0;
+static u32 report_busy = 0;
+
+
+// =============================================================================
+//                                 FUNCTIONS
+
+void sched_init(void)
+{
+    wheel_ms = ticker_millis();
+
+    report_ms   = wheel_ms;
+    report_busy = busy_cycles();
+}
+
+
+int sched_add(P_Task task)
+{
+    if (n_tasks == SCHED_MAX_TASKS)
+        return 0;
+
+    task->enabled = false;
+    tasks[n_tasks++] = task;
+
+    return 1;
+}
+
+
+void sched_enable(P_Task task, bool enabled)
+{
+    if (enabled && !task->enabled)
+        task->due_ms = ticker_millis();
+
+    task->enabled = enabled;
+}
+
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+void sched_timer_start(P_SoftTimer timer, u32 delay_ms, void (*fire)(void))
+{
+    sched_timer_cancel(timer);
+
+    // The slot of the current millisecond has been visited already.
+    u32 expires = ticker_millis() + delay_ms;
+    if ((i32)(expires - wheel_ms) <= 0)
+        expires = wheel_ms + 1;
+
+    P_SoftTimer *slot = &wheel[expires & (SCHED_WHEEL_SLOTS - 1)];
+
+    timer->fire       = fire;
+    timer->expires_ms = expires;
+    timer->next       = *slot;
+    timer->armed      = true;
+    *slot = timer;
+}
+
+
+void sched_timer_cancel(P_SoftTimer timer)
+{
+    if (!timer->armed)
+        return;
+
+    P_SoftTimer *link = &wheel[timer->expires_ms & (SCHED_WHEEL_SLOTS - 1)];
+
+    while (*link != timer)
+        link = &(*link)->next;
+
+    *link = timer->next;
+    timer->armed = false;
+}
+
+
+/**
+ * @brief Turn the wheel up to the current millisecond, one slot at a time,
+ *        and fire the timers that have expired. A slot is only a few timers
+ *        long, and those that are a turn or more away are skipped.
+ *
+ * @return Whether any timer fired.
+ */
+static bool turn_wheel(void)
+{
+    u32  now   = ticker_millis();
+    bool fired = false;
+
+    while (wheel_ms != now)
+    {
+        wheel_ms++;
+
+        P_SoftTimer *link = &wheel[wheel_ms & (SCHED_WHEEL_SLOTS - 1)];
+
+        while (*link)
+        {
+            P_SoftTimer timer = *link;
+
+            if (timer->expires_ms != wheel_ms)
+            {
+                link = &timer->next;
+                continue;
+            }
+
+            // Unlinked first, so the timer can be started again from `fire`.
+            *link = timer->next;
+            timer->armed = false;
+            timer->fire();
+            fired = true;
+        }
+    }
+
+    return fired;
+}
+
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+/**
+ * @brief Return whether a task has work. A periodic task that has fallen more
+ *        than a period behind skips the periods it missed.
+ */
+static bool task_due(P_Task task)
+{
+    if (!task->enabled)
+        return false;
+
+    if (task->ready)
+        return task->ready();
+
+    u32 now = ticker_millis();
+    if ((i32)(now - task->due_ms) < 0)
+        return false;
+
+    task->due_ms += task->period_ms;
+    if ((i32)(now - task->due_ms) >= 0)
+        task->due_ms = now + task->period_ms;
+
+    return true;
+}
+
+
+static void run_task(P_Task task)
+{
+    u32 start = cycles_now();
+    task->run();
+    u32 cycles = cycles_now() - start;
+
+    task->runs++;
+    task->sum_cycles += cycles;
+    if (cycles > task->max_cycles)
+        task->max_cycles = cycles;
+}
+
+
+bool sched_run_once(void)
+{
+    if (turn_wheel())
+        return true;
+
+    for (u32 i = 0; i < n_tasks; i++)
+    {
+        if (task_due(tasks[i]))
+        {
+            run_task(tasks[i]);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+void sched_run(void)
+{
+    while (true)
+    {
+        if (!sched_run_once())
+            wait_for_interrupt();
+    }
+}
+
+
+/**
+ * @brief The time between reports is taken from the ticker, as the cycle
+ *        counter may stop while the CPU sleeps.
+ */
+void sched_report(void)
+{
+    u32 now_ms = ticker_millis();
+    u32 busy   = busy_cycles();
+
+    unsigned long long window = (unsigned long long)(now_ms - report_ms) * 1000 * cycles_per_us();
+    unsigned long long used   = busy - report_busy;
+
+    if (used > window)
+        used = window;
+
+    if (window > 0)
+    {
+        uart_puts("load busy=");  uart_put_u32((u32)used);
+        uart_puts(" idle=");      uart_put_u32((u32)(window - used));
+        uart_puts(" percent=");   uart_put_u32((u32)(used * 100 / window));
+        uart_putc('\n');
+    }
+
+    report_ms   = now_ms;
+    report_busy = busy;
+
+    for (u32 i = 0; i < n_tasks; i++)
+    {
+        P_Task task = tasks[i];
+
+        if (task->runs == 0)
+            continue;
+
+        uart_puts("task ");
+        uart_puts(task->name);
+        uart_puts(" n=");   uart_put_u32(task->runs);
+        uart_puts(" avg="); uart_put_u32((u32)(task->sum_cycles / task->runs));
+        uart_puts(" max="); uart_put_u32(task->max_cycles);
+        uart_putc('\n');
+
+        task->runs       = 0;
+        task->sum_cycles = 0;
+        task->max_cycles = 0;
+    }
+}
@@ -0,0 +1,122 @@
+#include "ticker.h"
+
+// =============================================================================
+//                         INCLUDES & PRE-PROCESSOR
+
+#include "timer.h"
+#include "typedef.h"
+
+
+// =============================================================================
+//                                GLOBAL DATA
+
+TickerStats ticker_stats;
+
+// Only written by the interrupt.
+static volatile u32 millis = 0;
+static volatile u32 ticks  = 0;
+
+// Only written by ticker_wait().
+static u32 consumed = 0;
+
+static u32          tick_hz  = 1;
+static volatile u32 tick_acc = 0;
+
+static void (*handlers[TICKER_MAX_HANDLERS])(void);
+static volatile u32 n_handlers = 0;
+
+
+// =============================================================================
+//                                 FUNCTIONS
+
+/**
+ * @brief Runs at TICKER_BASE_HZ. Emits a logic tick every time enough base
+ *        periods have accumulated, so any rate up to the base rate is exact
+ *        on average.
+ */
+static void ticker_irq_handler(void)
+{
+    millis++;
+
+    tick_acc += tick_hz;
+    if (tick_acc >= TICKER_BASE_HZ)
+    {
+        tick_acc -= TICKER_BASE_HZ;
+        ticks++;
+    }
+
+    for (u32 i = 0; i < n_handlers; i++)
+        handlers[i]();
+}
+
+
+void ticker_init(u32 hz)
+{
+    tick_hz  = hz;
+    tick_acc = 0;
+    consumed = ticks;
+
+    timer_start(TICKER_BASE_HZ, ticker_irq_handler);
+}
+
+
+int ticker_attach(void (*handler)(void))
+{
+    if (n_handlers == TICKER_MAX_HANDLERS)
+        return 0;
+
+    // Publish the handler before the interrupt can see it.
+    handlers[n_handlers] = handler;
+    n_handlers++;
+
+    return 1;
+}
+
+
+u32 ticker_wait(void)
+{
+    while (ticks == consumed)
+        wait_for_interrupt();
+
+    u32 n = ticks - consumed;
+    consumed += n;
+
+    ticker_stats.frames++;
+
+    if (n > 1)
+        ticker_stats.overruns++;
+
+    if (n > TICKER_MAX_STEPS)
+    {
+        ticker_stats.dropped += n - TICKER_MAX_STEPS;
+        n = TICKER_MAX_STEPS;
+    }
+
+    ticker_stats.ticks += n;
+
+    return n;
+}
+
+
+bool ticker_pending(void)
+{
+    return ticks != consumed;
+}
+
+
+fixed ticker_phase(void)
+{
+    return (fixed)(tick_acc * FX_ONE / TICKER_BASE_HZ);
+}
+
+
+void ticker_sync(void)
+{
+    consumed = ticks;
+}
+
+
+u32 ticker_millis(void)
+{
+    return millis;
+}
@@ -0,0 +1,24 @@
+#include "uart.h"
+
+
+void uart_puts(const char *s)
+{
+    while (*s)
+        uart_putc(*s++);
+}
+
+
+void uart_put_u32(u32 n)
+{
+    char digits[10];
+    int  i = 0;
+
+    do
+    {
+        digits[i++] = '0' + n % 10;
+        n /= 10;
+    } while (n);
+
+    while (i)
+        uart_putc(digits[--i]);
+}